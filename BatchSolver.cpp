@@ -0,0 +1,232 @@
+#include "BatchSolver.h"
+#include <algorithm>
+#include <chrono>
+#include <iomanip>
+using namespace std;
+
+// Starts the worker threads; the calling thread also solves, so `threads - 1` workers are spawned.
+BatchSolver::BatchSolver(unsigned threads, const string& backendName, bool stats, size_t chunk)
+    : next(0),
+    generation(0),
+    busyWorkers(0),
+    stopping(false),
+    backend(backendName),
+    collectStats(stats),
+    cache(nullptr),
+    chunkSize(max<size_t>(1, chunk)) {
+    if (threads == 0) threads = max(1u, thread::hardware_concurrency());
+    for (unsigned i = 1; i < threads; i++) {
+        workers.emplace_back(&BatchSolver::workerLoop, this);
+    }
+}
+
+// Stops and joins the worker threads.
+BatchSolver::~BatchSolver() {
+    {
+        lock_guard<mutex> lock(poolMutex);
+        stopping = true;
+    }
+    wake.notify_all();
+    for (auto& worker : workers) worker.join();
+}
+
+// Waits for a new chunk, helps solve it and reports back when the chunk runs dry.
+void BatchSolver::workerLoop() {
+    unique_ptr<SolverBackend> solver = SolverBackend::create(backend, collectStats);
+    unsigned seen = 0;
+    while (true) {
+        {
+            unique_lock<mutex> lock(poolMutex);
+            wake.wait(lock, [&] { return stopping || generation != seen; });
+            if (stopping) return;
+            seen = generation;
+        }
+        solveRange(*solver);
+        {
+            lock_guard<mutex> lock(poolMutex);
+            if (--busyWorkers == 0) done.notify_one();
+        }
+    }
+}
+
+// Claims puzzles of the current chunk in groups of the engine's batch width until none are left.
+// Multi-puzzle engines solve a whole group at once, so each puzzle is charged the group's average time.
+void BatchSolver::solveRange(SolverBackend& solver) {
+    size_t count = grids.size();
+    size_t width = solver.batchWidth();
+    vector<SolverBackend::Grid> group(width);
+    vector<size_t> indices(width);
+    unique_ptr<bool[]> solved(new bool[width]);
+    SolverStats stats;
+
+    for (size_t start = next.fetch_add(width); start < count; start = next.fetch_add(width)) {
+        size_t end = min(count, start + width);
+        int n = 0;
+        for (size_t i = start; i < end; i++) {
+            latencies[i] = 0;
+            if (status[i] == INVALID) continue;
+            if (cache) {
+                auto begin = chrono::steady_clock::now();
+                bool solvable = false;
+                if (cache->lookup(grids[i], group[n], solvable)) {
+                    status[i] = solvable ? SOLVED : UNSOLVABLE;
+                    if (solvable) grids[i] = group[n];
+                    latencies[i] = chrono::duration<float, micro>(chrono::steady_clock::now() - begin).count();
+                    continue;
+                }
+            }
+            indices[n] = i;
+            group[n++] = grids[i];
+        }
+        if (n == 0) continue;
+
+        auto begin = chrono::steady_clock::now();
+        solver.solveMany(group.data(), solved.get(), n);
+        float micros = chrono::duration<float, micro>(chrono::steady_clock::now() - begin).count() / n;
+        if (const SolverStats* last = solver.getStats()) stats.add(*last);
+
+        for (int k = 0; k < n; k++) {
+            size_t i = indices[k];
+            if (cache) cache->store(grids[i], group[k], solved[k]);
+            status[i] = solved[k] ? SOLVED : UNSOLVABLE;
+            if (solved[k]) grids[i] = group[k];
+            latencies[i] = micros;
+        }
+    }
+
+    if (stats.solves > 0) {
+        lock_guard<mutex> lock(poolMutex);
+        chunkStats.add(stats);
+    }
+}
+
+// Hands the loaded chunk to the pool and blocks until every puzzle in it is done.
+void BatchSolver::solveChunk(SolverBackend& solver) {
+    {
+        lock_guard<mutex> lock(poolMutex);
+        next = 0;
+        busyWorkers = workers.size();
+        generation++;
+    }
+    wake.notify_all();
+    solveRange(solver);
+
+    unique_lock<mutex> lock(poolMutex);
+    done.wait(lock, [&] { return busyWorkers == 0; });
+}
+
+// Answers repeated puzzles from `solutions` and adds every new result to it; nullptr turns caching off.
+void BatchSolver::setCache(SolutionCache* solutions) {
+    cache = solutions;
+}
+
+// Parses one 81-character puzzle line ('0' or '.' for blanks).
+bool BatchSolver::parseLine(const string& line, SolverBackend::Grid& grid) {
+    size_t length = line.size();
+    while (length > 0 && isspace(static_cast<unsigned char>(line[length - 1]))) length--;
+    if (length != SolverBackend::CELLS) return false;
+
+    for (int i = 0; i < SolverBackend::CELLS; i++) {
+        char c = line[i];
+        if (c == '.' || c == '0') grid[i] = 0;
+        else if (c >= '1' && c <= '9') grid[i] = c - '0';
+        else return false;
+    }
+    return true;
+}
+
+// Streams puzzles from `in`, solves them chunk by chunk and writes one result line per puzzle in input order.
+BatchSolver::Summary BatchSolver::run(istream& in, ostream& out) {
+    Summary summary;
+    unique_ptr<SolverBackend> solver = SolverBackend::create(backend, collectStats);
+    summary.groupWidth = solver->batchWidth();
+    vector<float> allLatencies;
+    float slowest = -1;
+    chunkStats.reset();
+    string line;
+    string output;
+    auto begin = chrono::steady_clock::now();
+
+    while (in) {
+        grids.clear();
+        status.clear();
+        while (grids.size() < chunkSize && getline(in, line)) {
+            if (line.empty() || line[0] == '#' || line[0] == '\r') continue;
+            grids.emplace_back();
+            status.push_back(parseLine(line, grids.back()) ? UNSOLVABLE : INVALID);
+        }
+        if (grids.empty()) break;
+
+        latencies.assign(grids.size(), 0);
+        solveChunk(*solver);
+
+        output.clear();
+        for (size_t i = 0; i < grids.size(); i++) {
+            if (status[i] != INVALID && latencies[i] > slowest) {
+                slowest = latencies[i];
+                summary.slowestPuzzle = summary.puzzles + i + 1;
+            }
+            switch (status[i]) {
+                case SOLVED:
+                    for (uint8_t value : grids[i]) output += static_cast<char>('0' + value);
+                    summary.solved++;
+                    allLatencies.push_back(latencies[i]);
+                    break;
+                case UNSOLVABLE:
+                    output += "unsolvable";
+                    summary.unsolvable++;
+                    allLatencies.push_back(latencies[i]);
+                    break;
+                case INVALID:
+                    output += "invalid";
+                    summary.invalid++;
+                    break;
+            }
+            output += '\n';
+        }
+        out.write(output.data(), output.size());
+        summary.puzzles += grids.size();
+    }
+    out.flush();
+    summary.stats = chunkStats;
+    summary.hasStats = chunkStats.solves > 0;
+    summary.seconds = chrono::duration<double>(chrono::steady_clock::now() - begin).count();
+
+    if (!allLatencies.empty()) {
+        double total = 0;
+        for (float micros : allLatencies) total += micros;
+        summary.meanMicros = total / allLatencies.size();
+        auto percentile = [&](double p) {
+            size_t index = min(allLatencies.size() - 1, static_cast<size_t>(p * allLatencies.size()));
+            nth_element(allLatencies.begin(), allLatencies.begin() + index, allLatencies.end());
+            return static_cast<double>(allLatencies[index]);
+        };
+        summary.p50Micros = percentile(0.50);
+        summary.p99Micros = percentile(0.99);
+        summary.maxMicros = *max_element(allLatencies.begin(), allLatencies.end());
+    }
+    return summary;
+}
+
+// Prints throughput and latency figures for a finished run.
+void BatchSolver::printSummary(const Summary& summary, ostream& out) {
+    double rate = summary.seconds > 0 ? summary.puzzles / summary.seconds : 0;
+    out << fixed << setprecision(1)
+        << "Puzzles: " << summary.puzzles
+        << " (solved " << summary.solved
+        << ", unsolvable " << summary.unsolvable
+        << ", invalid " << summary.invalid << ")\n"
+        << "Time: " << setprecision(3) << summary.seconds << " s, "
+        << setprecision(0) << rate << " puzzles/s\n"
+        << "Latency: mean " << setprecision(1) << summary.meanMicros << " us";
+    if (summary.groupWidth > 1) {
+        // Puzzles solved in one group share its time, so there are no per-puzzle figures.
+        out << " (group average, " << summary.groupWidth << " puzzles per group)\n";
+    } else {
+        out << ", p50 " << summary.p50Micros << " us, p99 " << summary.p99Micros
+            << " us, max " << summary.maxMicros << " us";
+        if (summary.slowestPuzzle > 0) out << " (puzzle #" << summary.slowestPuzzle << ")";
+        out << "\n";
+    }
+    if (summary.hasStats) summary.stats.print(out);
+}
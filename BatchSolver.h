@@ -0,0 +1,72 @@
+#ifndef BATCH_SOLVER_H
+#define BATCH_SOLVER_H
+
+#include "SolverBackend.h"
+#include "SolutionCache.h"
+#include <atomic>
+#include <condition_variable>
+#include <iostream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+class BatchSolver {
+public:
+    struct Summary {
+        size_t puzzles = 0;
+        size_t solved = 0;
+        size_t unsolvable = 0;
+        size_t invalid = 0;
+        double seconds = 0;
+        double meanMicros = 0;
+        double p50Micros = 0;
+        double p99Micros = 0;
+        double maxMicros = 0;
+        size_t slowestPuzzle = 0;   // 1-based position of the slowest puzzle in the input.
+        size_t groupWidth = 1;      // Puzzles solved together; above 1 only the mean is meaningful.
+        SolverStats stats;          // Aggregated search statistics (instrumented engines only).
+        bool hasStats = false;
+    };
+
+private:
+    enum Status : uint8_t { SOLVED, UNSOLVABLE, INVALID };
+
+    // Puzzles of the chunk currently being solved; workers claim indices through `next`.
+    std::vector<SolverBackend::Grid> grids;
+    std::vector<Status> status;
+    std::vector<float> latencies;
+    std::atomic<size_t> next;
+
+    std::vector<std::thread> workers;
+    std::mutex poolMutex;
+    std::condition_variable wake;
+    std::condition_variable done;
+    unsigned generation;
+    unsigned busyWorkers;
+    bool stopping;
+
+    std::string backend;
+    bool collectStats;
+    SolutionCache* cache;
+    size_t chunkSize;
+    SolverStats chunkStats;
+
+    void workerLoop();
+    void solveRange(SolverBackend& solver);
+    void solveChunk(SolverBackend& solver);
+
+public:
+    explicit BatchSolver(unsigned threads = 0, const std::string& backendName = "bitmask",
+                         bool stats = false, size_t chunk = 4096);
+    ~BatchSolver();
+    BatchSolver(const BatchSolver&) = delete;
+    BatchSolver& operator=(const BatchSolver&) = delete;
+
+    void setCache(SolutionCache* solutions);
+    Summary run(std::istream& in, std::ostream& out);
+    static bool parseLine(const std::string& line, SolverBackend::Grid& grid);
+    static void printSummary(const Summary& summary, std::ostream& out);
+};
+
+#endif // BATCH_SOLVER_H
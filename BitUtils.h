@@ -0,0 +1,51 @@
+#ifndef BIT_UTILS_H
+#define BIT_UTILS_H
+
+#include <cstdint>
+
+// Number of set bits in a candidate mask.
+inline int bitCount(uint32_t mask) {
+#if defined(__GNUC__) || defined(__clang__)
+    return __builtin_popcount(mask);
+#else
+    int count = 0;
+    for (; mask; mask &= mask - 1) count++;
+    return count;
+#endif
+}
+
+// Set-bit counts of every 9-bit mask. The default build targets CPUs without popcnt,
+// where __builtin_popcount is a library call; for 9x9 candidate masks a lookup is cheaper.
+constexpr int SMALL_MASK_BITS = 9;
+
+struct SmallBitCounts {
+    uint8_t of[1 << SMALL_MASK_BITS];
+    constexpr SmallBitCounts() : of() {
+        for (int mask = 1; mask < (1 << SMALL_MASK_BITS); mask++) of[mask] = of[mask >> 1] + (mask & 1);
+    }
+};
+
+inline constexpr SmallBitCounts SMALL_BIT_COUNTS;
+
+// Number of set bits in a mask below 1 << SMALL_MASK_BITS.
+inline int smallBitCount(uint32_t mask) {
+    return SMALL_BIT_COUNTS.of[mask];
+}
+
+// Index of the lowest set bit; the mask must be non-zero.
+inline int lowestBit(uint32_t mask) {
+#if defined(__GNUC__) || defined(__clang__)
+    return __builtin_ctz(mask);
+#else
+    int index = 0;
+    while (!(mask & 1u)) { mask >>= 1; index++; }
+    return index;
+#endif
+}
+
+// True when exactly one bit is set.
+inline bool isSingleBit(uint32_t mask) {
+    return mask != 0 && (mask & (mask - 1)) == 0;
+}
+
+#endif // BIT_UTILS_H
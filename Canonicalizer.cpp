@@ -0,0 +1,275 @@
+#include "Canonicalizer.h"
+#include "BitUtils.h"
+#include <algorithm>
+#include <cstring>
+using namespace std;
+
+namespace {
+
+constexpr int SIZE = SudokuBoard::SIZE;
+constexpr int BOX = SudokuBoard::SUBGRID_SIZE;
+constexpr int CELLS = SudokuBoard::CELLS;
+
+using Grid = Canonicalizer::Grid;
+using Perm = array<uint8_t, BOX>;
+using Labels = array<uint8_t, SIZE + 1>;
+
+// Every order of three things: rows of a band, bands of the grid, columns of a stack...
+constexpr Perm PERMS[] = {{0, 1, 2}, {0, 2, 1}, {1, 0, 2}, {1, 2, 0}, {2, 0, 1}, {2, 1, 0}};
+
+// splitmix64 finalizer.
+uint64_t mix(uint64_t x) {
+    x ^= x >> 30;
+    x *= 0xbf58476d1ce4e5b9ULL;
+    x ^= x >> 27;
+    x *= 0x94d049bb133111ebULL;
+    return x ^ (x >> 31);
+}
+
+uint64_t combine(uint64_t seed, uint64_t value) {
+    return mix(seed ^ (value + 0x9e3779b97f4a7c15ULL));
+}
+
+// Insertion sort; these arrays hold at most six values, where std::sort costs more than it saves.
+template <size_t N>
+void sortSmall(array<uint64_t, N>& values) {
+    for (size_t i = 1; i < N; i++) {
+        uint64_t value = values[i];
+        size_t j = i;
+        for (; j > 0 && values[j - 1] > value; j--) values[j] = values[j - 1];
+        values[j] = value;
+    }
+}
+
+// Hashes the values in sorted order, so only the multiset matters.
+template <size_t N>
+uint64_t combineSorted(uint64_t seed, array<uint64_t, N> values) {
+    sortSmall(values);
+    for (uint64_t value : values) seed = combine(seed, value);
+    return seed;
+}
+
+// Signatures of the rows and bands of a grid. They survive column and stack swaps,
+// row and band swaps and relabelling, so equal grids up to those have equal signatures.
+struct Signatures {
+    uint64_t row[SIZE];
+    uint64_t band[BOX];
+    uint64_t grid;
+};
+
+// Per-row layout of digits over the stacks, the raw material of the pair signatures.
+struct RowStacks {
+    uint16_t digits[SIZE][BOX];     // Digits of each row inside each stack.
+    uint16_t filled[SIZE][BOX];     // Filled columns of each row inside each stack (3 bits).
+};
+
+// Order-free code for two small counts (0-3): one 4-bit tally per value.
+inline uint64_t unordered(int x, int y) {
+    return (uint64_t(1) << (4 * x)) + (uint64_t(1) << (4 * y));
+}
+
+// Summary of one stack: how full it is in either row and in both, how many digits stay in
+// it from one row to the other, and how many go to or come from the other two stacks.
+// Every part is order-free, so the code does not change when the rows are swapped.
+inline uint64_t stackCode(const int (&shared)[BOX][BOX], const RowStacks& rs, int a, int b, int s) {
+    int t1 = s == 0 ? 1 : 0, t2 = s == 2 ? 1 : 2;
+    uint64_t out = unordered(shared[s][t1], shared[s][t2]);
+    uint64_t in = unordered(shared[t1][s], shared[t2][s]);
+    return min(out, in) | max(out, in) << 16
+         | uint64_t(shared[s][s]) << 32 | uint64_t(smallBitCount(rs.filled[a][s] & rs.filled[b][s])) << 36
+         | unordered(smallBitCount(rs.filled[a][s]), smallBitCount(rs.filled[b][s])) << 40;
+}
+
+// Compares two rows stack by stack: how many digits row `a` keeps in stack s that row `b`
+// keeps in stack t, and how full each stack is in both rows. Column swaps inside a stack
+// leave this unchanged and a stack swap only reorders it, so the stacks are summarized
+// without naming each other and the summaries hashed in an order-free sum.
+uint64_t pairSignature(const RowStacks& rs, int a, int b) {
+    int shared[BOX][BOX];
+    for (int s = 0; s < BOX; s++) {
+        for (int t = 0; t < BOX; t++) shared[s][t] = smallBitCount(rs.digits[a][s] & rs.digits[b][t]);
+    }
+    uint64_t sig = 0;
+    for (int s = 0; s < BOX; s++) sig += mix(stackCode(shared, rs, a, b, s));
+    return sig;
+}
+
+void computeSignatures(const Grid& g, Signatures& sigs) {
+    RowStacks rs{};
+    for (int row = 0; row < SIZE; row++) {
+        for (int col = 0; col < SIZE; col++) {
+            int digit = g[row * SIZE + col];
+            if (!digit) continue;
+            rs.digits[row][col / BOX] |= uint16_t(1) << (digit - 1);
+            rs.filled[row][col / BOX] |= uint16_t(1) << (col % BOX);
+        }
+    }
+
+    uint64_t pairs[SIZE][SIZE];
+    for (int row = 0; row < SIZE; row++) {
+        for (int peer = row + 1; peer < SIZE; peer++) pairs[row][peer] = pairs[peer][row] = pairSignature(rs, row, peer);
+    }
+
+    for (int row = 0; row < SIZE; row++) {
+        array<uint64_t, BOX> filled;
+        for (int stack = 0; stack < BOX; stack++) filled[stack] = smallBitCount(rs.filled[row][stack]);
+        array<uint64_t, BOX - 1> sameBand;
+        array<uint64_t, SIZE - BOX> otherBands;
+        int same = 0, other = 0;
+        for (int peer = 0; peer < SIZE; peer++) {
+            if (peer == row) continue;
+            if (peer / BOX == row / BOX) sameBand[same++] = pairs[row][peer];
+            else otherBands[other++] = pairs[row][peer];
+        }
+        sigs.row[row] = combineSorted(combineSorted(combineSorted(1, filled), sameBand), otherBands);
+    }
+
+    array<uint64_t, BOX> bands;
+    for (int band = 0; band < BOX; band++) {
+        sigs.band[band] = combineSorted(2, array<uint64_t, BOX>{sigs.row[band * BOX], sigs.row[band * BOX + 1],
+                                                                  sigs.row[band * BOX + 2]});
+        bands[band] = sigs.band[band];
+    }
+    sigs.grid = combineSorted(3, bands);
+}
+
+uint64_t hashCells(const Grid& g) {
+    uint64_t h = combine(0, CELLS);
+    for (int cell = 0; cell < CELLS; cell += 8) {
+        uint64_t word = 0;
+        memcpy(&word, g.data() + cell, min(8, CELLS - cell));
+        h = combine(h, word);
+    }
+    return h;
+}
+
+Grid transposed(const Grid& g) {
+    Grid t;
+    for (int row = 0; row < SIZE; row++) {
+        for (int col = 0; col < SIZE; col++) t[col * SIZE + row] = g[row * SIZE + col];
+    }
+    return t;
+}
+
+// The orders of three items that list their keys in non-decreasing order.
+struct Orders {
+    Perm perms[6];
+    int count = 0;
+    const Perm* begin() const { return perms; }
+    const Perm* end() const { return perms + count; }
+};
+
+Orders sortedOrders(const uint64_t* keys) {
+    Orders orders;
+    for (const Perm& p : PERMS) {
+        if (keys[p[0]] <= keys[p[1]] && keys[p[1]] <= keys[p[2]]) orders.perms[orders.count++] = p;
+    }
+    return orders;
+}
+
+// Branch and bound for the smallest relabelled string. Rows are placed a band at a time,
+// and an arrangement is dropped at the first cell where it exceeds the best one so far.
+struct Search {
+    const Grid* view = nullptr;
+    array<uint8_t, SIZE> cols{};
+    Orders bandOrders;
+    Orders rowOrders[BOX];
+    Grid out{};
+    Grid best{};
+    bool found = false;
+    unsigned improvements = 0;
+
+    void run() {
+        for (const Perm& bands : bandOrders) placeBand(bands, 0, Labels{}, 0, false);
+    }
+
+    // `better` means the rows placed so far already beat the best string's prefix.
+    void placeBand(const Perm& bands, int band, const Labels& labels, uint8_t used, bool better) {
+        int source = bands[band];
+        for (const Perm& rows : rowOrders[source]) {
+            Labels local = labels;
+            uint8_t next = used;
+            bool ahead = better || !found;
+            bool pruned = false;
+            for (int i = 0; i < BOX && !pruned; i++) {
+                const uint8_t* src = view->data() + (source * BOX + rows[i]) * SIZE;
+                int base = (band * BOX + i) * SIZE;
+                for (int col = 0; col < SIZE; col++) {
+                    uint8_t digit = src[cols[col]];
+                    uint8_t value = 0;
+                    if (digit) {
+                        if (!local[digit]) local[digit] = ++next;
+                        value = local[digit];
+                    }
+                    out[base + col] = value;
+                    if (!ahead) {
+                        if (value > best[base + col]) {
+                            pruned = true;
+                            break;
+                        }
+                        ahead = value < best[base + col];
+                    }
+                }
+            }
+            if (pruned) continue;
+
+            if (band + 1 == BOX) {
+                if (ahead) {
+                    best = out;
+                    found = true;
+                    improvements++;
+                    better = false;     // The new best shares this prefix.
+                }
+                continue;
+            }
+            unsigned before = improvements;
+            placeBand(bands, band + 1, local, next, ahead);
+            if (improvements != before) better = false;
+        }
+    }
+};
+
+} // namespace
+
+// Tries both orientations unless the signatures tell them apart, and within one only the
+// band, row, stack and column orders that sort their signatures; ties are all explored.
+Canonicalizer::Canonical Canonicalizer::canonicalize(const Grid& grid) {
+    Grid flipped = transposed(grid);
+    Signatures sigs[2];
+    computeSignatures(grid, sigs[0]);
+    computeSignatures(flipped, sigs[1]);
+
+    Search search;
+    for (int orientation = 0; orientation < 2; orientation++) {
+        const Signatures& rows = sigs[orientation];
+        const Signatures& cols = sigs[1 - orientation];
+        if (make_pair(rows.grid, cols.grid) > make_pair(cols.grid, rows.grid)) continue;
+
+        search.view = orientation ? &flipped : &grid;
+        search.bandOrders = sortedOrders(rows.band);
+        for (int band = 0; band < BOX; band++) search.rowOrders[band] = sortedOrders(rows.row + band * BOX);
+
+        Orders inner[BOX];
+        for (int stack = 0; stack < BOX; stack++) inner[stack] = sortedOrders(cols.row + stack * BOX);
+        for (const Perm& stacks : sortedOrders(cols.band)) {
+            for (const Perm& a : inner[stacks[0]]) {
+                for (const Perm& b : inner[stacks[1]]) {
+                    for (const Perm& c : inner[stacks[2]]) {
+                        const Perm* within[BOX] = {&a, &b, &c};
+                        for (int col = 0; col < SIZE; col++) {
+                            search.cols[col] = stacks[col / BOX] * BOX + (*within[col / BOX])[col % BOX];
+                        }
+                        search.run();
+                    }
+                }
+            }
+        }
+    }
+
+    return {search.best, hashCells(search.best)};
+}
+
+// Hash of the grid's class, for keying caches and spotting duplicates.
+uint64_t Canonicalizer::hash(const Grid& grid) {
+    return canonicalize(grid).hash;
+}
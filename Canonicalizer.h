@@ -0,0 +1,27 @@
+#ifndef CANONICALIZER_H
+#define CANONICALIZER_H
+
+#include "SudokuBoard.h"
+#include <cstdint>
+
+// Maps a 9x9 grid or puzzle (0 = empty) to one representative of its class under every
+// symmetry that keeps a Sudoku valid: transposition, band and stack swaps, row and column
+// swaps inside them, and digit relabelling. Isomorphic grids get the same form and hash.
+//
+// The representative is the smallest row-major string over a subset of the symmetries
+// chosen by relabelling-invariant row and column signatures, so a typical grid is settled
+// after a handful of candidates instead of all 3,359,232 arrangements.
+class Canonicalizer {
+public:
+    using Grid = SudokuBoard::Grid;
+
+    struct Canonical {
+        Grid grid;          // Digits relabelled in order of first appearance.
+        uint64_t hash;      // Hash of `grid`; equal for every grid in the class.
+    };
+
+    static Canonical canonicalize(const Grid& grid);
+    static uint64_t hash(const Grid& grid);
+};
+
+#endif
@@ -0,0 +1,80 @@
+#include "DifficultyRater.h"
+#include <algorithm>
+using namespace std;
+
+namespace {
+
+using Traits = SudokuBoard::Traits;
+constexpr int SIZE = Traits::SIZE;
+constexpr int CELLS = Traits::CELLS;
+
+} // namespace
+
+// Solves with singles while it can and falls back to the elimination techniques,
+// cheapest first, only when no single is left.
+DifficultyRater::Rating DifficultyRater::rate(const Grid& puzzle) {
+    HintEngine::Candidates cells;
+    cells.fill(Traits::ALL_DIGITS);
+    int empty = CELLS;
+    for (int cell = 0; cell < CELLS; cell++) {
+        if (puzzle[cell] != 0) {
+            HintEngine::place(cells, cell, puzzle[cell]);
+            empty--;
+        }
+    }
+    // Placing a given can strip candidates from an earlier given; filled cells must stay 0.
+    for (int cell = 0; cell < CELLS; cell++) {
+        if (puzzle[cell] != 0) cells[cell] = 0;
+    }
+
+    Rating rating;
+    while (empty > 0) {
+        HintEngine::Hint single;
+        if (HintEngine::findSingle(cells, single)) {
+            HintEngine::place(cells, single.row * SIZE + single.col, single.value);
+            rating.hardest = max(rating.hardest, single.technique);
+            rating.placements++;
+            empty--;
+            continue;
+        }
+
+        Technique used;
+        if (!HintEngine::eliminate(cells, HintEngine::X_WING, used)) {
+            rating.hardest = HintEngine::SOLUTION;
+            break;
+        }
+        rating.hardest = max(rating.hardest, used);
+        rating.eliminations++;
+    }
+    rating.level = levelOf(rating.hardest);
+    return rating;
+}
+
+// Rates the puzzle a board was dealt with (its givens), whatever the player has filled in since.
+DifficultyRater::Rating DifficultyRater::rate(const SudokuBoard& board) {
+    Grid puzzle{};
+    for (int row = 0; row < SIZE; row++) {
+        for (int col = 0; col < SIZE; col++) {
+            if (board.isGiven(row, col)) puzzle[row * SIZE + col] = board.getValue(row, col);
+        }
+    }
+    return rate(puzzle);
+}
+
+// Rating band for each difficulty level (1 = Very Easy ... 4 = Hard).
+DifficultyRater::Band DifficultyRater::bandOf(int difficulty) {
+    switch (difficulty) {
+        case 1: return {HintEngine::NAKED_SINGLE, HintEngine::NAKED_SINGLE};
+        case 2: return {HintEngine::HIDDEN_SINGLE, HintEngine::HIDDEN_SINGLE};
+        case 3: return {HintEngine::LOCKED_CANDIDATES, HintEngine::HIDDEN_PAIR};
+        default: return {HintEngine::X_WING, HintEngine::SOLUTION};
+    }
+}
+
+// Lowest difficulty level whose band admits the given hardest technique.
+int DifficultyRater::levelOf(Technique hardest) {
+    for (int level = 1; level < 4; level++) {
+        if (hardest <= bandOf(level).hardest) return level;
+    }
+    return 4;
+}
@@ -0,0 +1,33 @@
+#ifndef DIFFICULTY_RATER_H
+#define DIFFICULTY_RATER_H
+
+#include "HintEngine.h"
+
+// Rates a 9x9 puzzle by solving it with human techniques only, cheapest first,
+// and scoring it by the hardest technique the solve could not do without.
+// There is no search, so a rating costs a few microseconds.
+class DifficultyRater {
+public:
+    using Grid = SudokuBoard::Grid;
+    using Technique = HintEngine::Technique;
+
+    struct Rating {
+        Technique hardest = HintEngine::NAKED_SINGLE;  // SOLUTION when the techniques get stuck.
+        int placements = 0;     // Cells filled by the logical solve.
+        int eliminations = 0;   // Steps that only removed candidates.
+        int level = 1;          // Difficulty level (1-4) whose band contains this rating.
+    };
+
+    // Techniques accepted for each difficulty level, easiest to hardest.
+    struct Band {
+        Technique easiest;
+        Technique hardest;
+    };
+
+    static Rating rate(const Grid& puzzle);
+    static Rating rate(const SudokuBoard& board);
+    static Band bandOf(int difficulty);
+    static int levelOf(Technique hardest);
+};
+
+#endif
@@ -0,0 +1,231 @@
+#include "DlxSolver.h"
+using namespace std;
+
+// Builds the exact-cover matrix: one row per (cell, digit) and four constraint columns per row
+// (cell filled, digit in row, digit in column, digit in box).
+template <int BOX>
+BasicDlxSolver<BOX>::BasicDlxSolver()
+    : nodes(1 + COLUMNS + 4 * ROWS),
+    columnSize(COLUMNS + 1, 0),
+    depth(0),
+    nodeCount(0) {
+    for (int i = 0; i <= COLUMNS; i++) {
+        nodes[i] = {i == 0 ? COLUMNS : i - 1, i == COLUMNS ? 0 : i + 1, i, i, i, -1};
+    }
+
+    for (int r = 0; r < ROWS; r++) {
+        int cell = r / SIZE;
+        int digit = r % SIZE;
+        int row = cell / SIZE;
+        int col = cell % SIZE;
+        int box = (row / SUBGRID_SIZE) * SUBGRID_SIZE + col / SUBGRID_SIZE;
+        const int columns[4] = {
+            1 + cell,
+            1 + CELLS + row * SIZE + digit,
+            1 + 2 * CELLS + col * SIZE + digit,
+            1 + 3 * CELLS + box * SIZE + digit
+        };
+
+        int base = firstNode(r);
+        for (int k = 0; k < 4; k++) {
+            int n = base + k;
+            int c = columns[k];
+            nodes[n].left = base + (k + 3) % 4;
+            nodes[n].right = base + (k + 1) % 4;
+            nodes[n].column = c;
+            nodes[n].row = r;
+            nodes[n].up = nodes[c].up;
+            nodes[n].down = c;
+            nodes[nodes[c].up].down = n;
+            nodes[c].up = n;
+            columnSize[c]++;
+        }
+    }
+}
+
+// Name used to select this engine at runtime.
+template <int BOX>
+string BasicDlxSolver<BOX>::name() const {
+    return "dlx";
+}
+
+// Index of the first node of a matrix row.
+template <int BOX>
+int BasicDlxSolver<BOX>::firstNode(int row) const {
+    return 1 + COLUMNS + 4 * row;
+}
+
+// Removes a column and every row that intersects it.
+template <int BOX>
+void BasicDlxSolver<BOX>::cover(int column) {
+    nodes[nodes[column].right].left = nodes[column].left;
+    nodes[nodes[column].left].right = nodes[column].right;
+    for (int i = nodes[column].down; i != column; i = nodes[i].down) {
+        for (int j = nodes[i].right; j != i; j = nodes[j].right) {
+            nodes[nodes[j].up].down = nodes[j].down;
+            nodes[nodes[j].down].up = nodes[j].up;
+            columnSize[nodes[j].column]--;
+        }
+    }
+}
+
+// Exact inverse of cover(); must be called in reverse order.
+template <int BOX>
+void BasicDlxSolver<BOX>::uncover(int column) {
+    for (int i = nodes[column].up; i != column; i = nodes[i].up) {
+        for (int j = nodes[i].left; j != i; j = nodes[j].left) {
+            columnSize[nodes[j].column]++;
+            nodes[nodes[j].up].down = j;
+            nodes[nodes[j].down].up = j;
+        }
+    }
+    nodes[nodes[column].right].left = column;
+    nodes[nodes[column].left].right = column;
+}
+
+// True if the column header has been unlinked from the header list.
+template <int BOX>
+bool BasicDlxSolver<BOX>::isCovered(int column) const {
+    return nodes[nodes[column].left].right != column;
+}
+
+// Selects the matrix rows of the givens; returns how many were selected, or -1 on a conflict
+// (in which case everything selected so far has already been undone).
+template <int BOX>
+int BasicDlxSolver<BOX>::coverGivens(const Grid& grid, int* chosen) {
+    int count = 0;
+    for (int cell = 0; cell < CELLS; cell++) {
+        int value = grid[cell];
+        if (value == 0) continue;
+
+        int first = value <= SIZE ? firstNode(cell * SIZE + value - 1) : -1;
+        bool conflict = first < 0;
+        for (int k = 0; !conflict && k < 4; k++) {
+            conflict = isCovered(nodes[first + k].column);
+        }
+        if (conflict) {
+            uncoverGivens(chosen, count);
+            return -1;
+        }
+
+        cover(nodes[first].column);
+        for (int j = nodes[first].right; j != first; j = nodes[j].right) cover(nodes[j].column);
+        chosen[count++] = nodes[first].row;
+    }
+    return count;
+}
+
+// Undoes coverGivens() in reverse order.
+template <int BOX>
+void BasicDlxSolver<BOX>::uncoverGivens(const int* chosen, int count) {
+    while (count-- > 0) {
+        int first = firstNode(chosen[count]);
+        for (int j = nodes[first].left; j != first; j = nodes[j].left) uncover(nodes[j].column);
+        uncover(nodes[first].column);
+    }
+}
+
+// Writes the givens plus the rows on the current search path into a grid.
+template <int BOX>
+void BasicDlxSolver<BOX>::fillGrid(const Grid& givens, Grid& grid) const {
+    grid = givens;
+    for (int i = 0; i < depth; i++) {
+        grid[partial[i] / SIZE] = partial[i] % SIZE + 1;
+    }
+}
+
+// Algorithm X, branching on the column with the fewest rows; returns false once `visit` asks to stop.
+template <int BOX>
+template <typename Visit>
+bool BasicDlxSolver<BOX>::search(Visit& visit) {
+    nodeCount++;
+    if (nodes[ROOT].right == ROOT) return visit();
+
+    int best = nodes[ROOT].right;
+    for (int c = nodes[best].right; c != ROOT && columnSize[best] > 1; c = nodes[c].right) {
+        if (columnSize[c] < columnSize[best]) best = c;
+    }
+    if (columnSize[best] == 0) return true;
+
+    bool keepGoing = true;
+    cover(best);
+    for (int r = nodes[best].down; r != best && keepGoing; r = nodes[r].down) {
+        partial[depth++] = nodes[r].row;
+        for (int j = nodes[r].right; j != r; j = nodes[j].right) cover(nodes[j].column);
+        keepGoing = search(visit);
+        for (int j = nodes[r].left; j != r; j = nodes[j].left) uncover(nodes[j].column);
+        depth--;
+    }
+    uncover(best);
+    return keepGoing;
+}
+
+// Solves a grid in place, stopping at the first solution.
+template <int BOX>
+bool BasicDlxSolver<BOX>::solve(Grid& grid) {
+    nodeCount = 0;
+    depth = 0;
+    int chosen[CELLS];
+    int given = coverGivens(grid, chosen);
+    if (given < 0) return false;
+
+    Grid result;
+    bool found = false;
+    auto visit = [&]() {
+        fillGrid(grid, result);
+        found = true;
+        return false;
+    };
+    search(visit);
+    uncoverGivens(chosen, given);
+
+    if (found) grid = result;
+    return found;
+}
+
+// Counts solutions, stopping as soon as `limit` of them have been found.
+template <int BOX>
+int BasicDlxSolver<BOX>::countSolutions(const Grid& grid, int limit) {
+    nodeCount = 0;
+    depth = 0;
+    int chosen[CELLS];
+    int given = coverGivens(grid, chosen);
+    if (given < 0) return 0;
+
+    int found = 0;
+    auto visit = [&]() { return ++found < limit; };
+    search(visit);
+    uncoverGivens(chosen, given);
+    return found;
+}
+
+// Visits every solution until the visitor asks to stop.
+template <int BOX>
+long long BasicDlxSolver<BOX>::enumerateSolutions(const Grid& grid, const SolutionVisitor& visitSolution) {
+    nodeCount = 0;
+    depth = 0;
+    int chosen[CELLS];
+    int given = coverGivens(grid, chosen);
+    if (given < 0) return 0;
+
+    long long found = 0;
+    Grid solution;
+    auto visit = [&]() {
+        fillGrid(grid, solution);
+        found++;
+        return visitSolution(solution);
+    };
+    search(visit);
+    uncoverGivens(chosen, given);
+    return found;
+}
+
+// Number of search nodes visited by the last solve, count or enumeration.
+template <int BOX>
+long long BasicDlxSolver<BOX>::getNodeCount() const {
+    return nodeCount;
+}
+
+template class BasicDlxSolver<3>;
+template class BasicDlxSolver<4>;
+template class BasicDlxSolver<5>;
@@ -0,0 +1,59 @@
+#ifndef DLX_SOLVER_H
+#define DLX_SOLVER_H
+
+#include "SolverBackend.h"
+#include <vector>
+
+// Exact-cover solver (Knuth's Algorithm X with Dancing Links).
+// The whole matrix (729x324 for 9x9) lives in one node array built once in the constructor;
+// every search uncovers what it covered, so the matrix is reused without copying.
+template <int BOX>
+class BasicDlxSolver : public BasicSolverBackend<BOX> {
+public:
+    using Traits = GridTraits<BOX>;
+    using Grid = typename Traits::Grid;
+    using SolutionVisitor = typename BasicSolverBackend<BOX>::SolutionVisitor;
+
+    static constexpr int SIZE = Traits::SIZE;
+    static constexpr int SUBGRID_SIZE = Traits::SUBGRID_SIZE;
+    static constexpr int CELLS = Traits::CELLS;
+
+private:
+    static constexpr int COLUMNS = 4 * CELLS;
+    static constexpr int ROWS = CELLS * SIZE;
+    static constexpr int ROOT = 0;
+
+    struct Node {
+        int left, right, up, down;
+        int column;
+        int row;
+    };
+
+    std::vector<Node> nodes;       // Root, column headers 1..COLUMNS, then 4 nodes per matrix row.
+    std::vector<int> columnSize;
+    int partial[CELLS];            // Matrix rows chosen on the current search path.
+    int depth;
+    long long nodeCount;
+
+    void cover(int column);
+    void uncover(int column);
+    bool isCovered(int column) const;
+    int firstNode(int row) const;
+    int coverGivens(const Grid& grid, int* chosen);
+    void uncoverGivens(const int* chosen, int count);
+    void fillGrid(const Grid& givens, Grid& grid) const;
+    template <typename Visit>
+    bool search(Visit& visit);
+
+public:
+    BasicDlxSolver();
+    std::string name() const override;
+    bool solve(Grid& grid) override;
+    int countSolutions(const Grid& grid, int limit = 2) override;
+    long long enumerateSolutions(const Grid& grid, const SolutionVisitor& visit) override;
+    long long getNodeCount() const override;
+};
+
+using DlxSolver = BasicDlxSolver<3>;
+
+#endif // DLX_SOLVER_H
@@ -0,0 +1,401 @@
+#include "GameServer.h"
+#include <cstring>
+#include <iostream>
+#include <sstream>
+
+#ifdef __linux__
+    #include <arpa/inet.h>
+    #include <fcntl.h>
+    #include <netinet/in.h>
+    #include <netinet/tcp.h>
+    #include <sys/epoll.h>
+    #include <sys/resource.h>
+    #include <sys/socket.h>
+    #include <sys/un.h>
+    #include <unistd.h>
+    #include <cerrno>
+#endif
+
+using namespace std;
+
+GameServer::Connection::Connection(int socket, PuzzlePool& pool, Leaderboard* leaderboard)
+    : fd(socket), closing(false), interest(0), session(pool, leaderboard) {}
+
+GameServer::GameServer(PuzzlePool& pool, Leaderboard& results, MoveJournal* moves)
+    : puzzlePool(pool), leaderboard(results), journal(moves), listenFd(-1), epollFd(-1), acceptPaused(false), running(false), commandCount(0) {}
+
+GameServer::~GameServer() {
+#ifdef __linux__
+    for (auto& entry : connections) close(entry.first);
+    if (listenFd >= 0) close(listenFd);
+    if (epollFd >= 0) close(epollFd);
+#endif
+}
+
+// Whether this platform has the event loop the server needs.
+bool GameServer::isSupported() {
+#ifdef __linux__
+    return true;
+#else
+    return false;
+#endif
+}
+
+size_t GameServer::sessionCount() const {
+    return connections.size();
+}
+
+size_t GameServer::parkedCount() const {
+    return parked.size();
+}
+
+long long GameServer::getCommandCount() const {
+    return commandCount;
+}
+
+// A resume token: 128 bits from the system's entropy source, as hex. A seeded generator
+// would let a client that has seen a few tokens work out everyone else's.
+string GameServer::newToken() {
+    static const char HEX[] = "0123456789abcdef";
+    string token;
+    for (int word = 0; word < 4; word++) {
+        uint32_t bits = entropy();
+        for (int i = 0; i < 8; i++, bits >>= 4) token += HEX[bits & 0xF];
+    }
+    return token;
+}
+
+// Asks run() to return; safe to call from a signal handler.
+void GameServer::stop() {
+    running = false;
+}
+
+// Applies one protocol line to the connection's session and queues the reply.
+void GameServer::handleLine(Connection& connection, const string& line) {
+    commandCount++;
+    istringstream in(line);
+    string command;
+    in >> command;
+    GameSession& session = connection.session;
+    ostringstream reply;
+
+    auto fail = [&](const GameResult& result) { reply << "ERR " << result.error; };
+    if (command == "NEW") {
+        string name;
+        int level = 0;
+        in >> name >> level;
+        GameResult result = session.newGame(name, level);
+        if (result.ok) {
+            connection.token = newToken();
+            reply << "OK " << session.boardString() << " " << connection.token;
+        } else {
+            fail(result);
+        }
+    } else if (command == "RESUME") {
+        string name, token;
+        in >> name >> token;
+        auto found = parked.find(token);
+        if (found == parked.end() || found->second.name != name) {
+            reply << "ERR No saved game for " << name << " with that token";
+        } else {
+            GameResult result = session.resume(name, found->second.snapshot);
+            if (result.ok) {
+                parked.erase(found);
+                connection.token = newToken();
+                reply << "OK " << session.boardString() << " " << result.score << " " << result.seconds << " "
+                      << connection.token;
+            } else {
+                fail(result);
+            }
+        }
+    } else if (command == "MOVE") {
+        int row = 0, col = 0, value = 0;
+        if (!(in >> row >> col >> value)) {
+            reply << "ERR Expected MOVE <row> <col> <value>";
+        } else {
+            GameResult result = session.move(row - 1, col - 1, value);
+            if (!result.ok) fail(result);
+            else if (result.solved) reply << "SOLVED " << result.score << " " << result.timeBonus << " " << result.seconds;
+            else reply << "OK " << result.score;
+        }
+    } else if (command == "DEL") {
+        int row = 0, col = 0;
+        if (!(in >> row >> col)) {
+            reply << "ERR Expected DEL <row> <col>";
+        } else {
+            GameResult result = session.erase(row - 1, col - 1);
+            if (result.ok) reply << "OK " << result.score;
+            else fail(result);
+        }
+    } else if (command == "HINT") {
+        GameResult result = session.hint();
+        if (result.ok) {
+            reply << "HINT " << result.row + 1 << " " << result.col + 1 << " " << result.value << " " << result.score
+                  << " " << result.technique;
+        } else {
+            fail(result);
+        }
+    } else if (command == "BOARD") {
+        reply << "BOARD " << session.boardString() << " " << session.getScore() << " " << session.elapsedSeconds();
+    } else if (command == "QUIT") {
+        reply << "BYE";
+        connection.closing = true;
+    } else {
+        reply << "ERR Unknown command";
+    }
+    connection.output += reply.str();
+    connection.output += '\n';
+}
+
+#ifdef __linux__
+
+static bool setNonBlocking(int fd) {
+    int flags = fcntl(fd, F_GETFL, 0);
+    return flags >= 0 && fcntl(fd, F_SETFL, flags | O_NONBLOCK) == 0;
+}
+
+// Makes a bound socket the listening socket and registers it with a new epoll instance.
+bool GameServer::startListening(int socket) {
+    // Every session holds a descriptor; allow as many as the hard limit permits.
+    rlimit limit;
+    if (getrlimit(RLIMIT_NOFILE, &limit) == 0 && limit.rlim_cur < limit.rlim_max) {
+        limit.rlim_cur = limit.rlim_max;
+        setrlimit(RLIMIT_NOFILE, &limit);
+    }
+    if (listen(socket, SOMAXCONN) != 0 || !setNonBlocking(socket)) {
+        close(socket);
+        return false;
+    }
+    epollFd = epoll_create1(0);
+    if (epollFd < 0) {
+        close(socket);
+        return false;
+    }
+    epoll_event event = {};
+    event.events = EPOLLIN;
+    event.data.fd = socket;
+    epoll_ctl(epollFd, EPOLL_CTL_ADD, socket, &event);
+    listenFd = socket;
+    return true;
+}
+
+// Listens on 127.0.0.1:port.
+bool GameServer::listenTcp(int port) {
+    int socketFd = socket(AF_INET, SOCK_STREAM, 0);
+    if (socketFd < 0) return false;
+    int yes = 1;
+    setsockopt(socketFd, SOL_SOCKET, SO_REUSEADDR, &yes, sizeof(yes));
+
+    sockaddr_in address = {};
+    address.sin_family = AF_INET;
+    address.sin_port = htons(static_cast<uint16_t>(port));
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    if (bind(socketFd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0) {
+        close(socketFd);
+        return false;
+    }
+    return startListening(socketFd);
+}
+
+// Listens on a Unix domain socket, replacing a stale socket file.
+bool GameServer::listenUnix(const string& path) {
+    sockaddr_un address = {};
+    if (path.size() >= sizeof(address.sun_path)) return false;
+    int socketFd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (socketFd < 0) return false;
+
+    address.sun_family = AF_UNIX;
+    memcpy(address.sun_path, path.c_str(), path.size() + 1);
+    unlink(path.c_str());
+    if (bind(socketFd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0) {
+        close(socketFd);
+        return false;
+    }
+    return startListening(socketFd);
+}
+
+// Starts or stops watching the listening socket. The socket is level-triggered, so while
+// no descriptor is free for accept() it has to be dropped from the interest set, or the
+// pending connection would wake epoll_wait on every pass.
+void GameServer::watchListener(bool watch) {
+    epoll_event event = {};
+    event.events = watch ? static_cast<uint32_t>(EPOLLIN) : 0u;
+    event.data.fd = listenFd;
+    epoll_ctl(epollFd, EPOLL_CTL_MOD, listenFd, &event);
+    acceptPaused = !watch;
+}
+
+// Accepts every pending connection and gives each a fresh session. Out of descriptors,
+// it stops watching for new ones until a session closes or the loop has been idle for a
+// while (the shortage may be system-wide); they wait in the backlog meanwhile.
+void GameServer::acceptConnections() {
+    while (true) {
+        int fd = accept4(listenFd, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+        if (fd < 0) {
+            if (errno == EINTR || errno == ECONNABORTED) continue;
+            if (errno == EMFILE || errno == ENFILE || errno == ENOBUFS || errno == ENOMEM) {
+                watchListener(false);
+            }
+            return;
+        }
+
+        int yes = 1;
+        setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &yes, sizeof(yes)); // Fails harmlessly on Unix sockets.
+        epoll_event event = {};
+        event.events = EPOLLIN | EPOLLRDHUP;
+        event.data.fd = fd;
+        if (epoll_ctl(epollFd, EPOLL_CTL_ADD, fd, &event) != 0) {
+            close(fd);
+            continue;
+        }
+        auto connection = make_unique<Connection>(fd, puzzlePool, &leaderboard);
+        connection->session.setJournal(journal);
+        connection->interest = event.events;
+        connections[fd] = move(connection);
+    }
+}
+
+// Runs the complete lines received so far through the session, until the replies
+// waiting to be sent reach MAX_OUTPUT.
+void GameServer::handleLines(Connection& connection) {
+    size_t start = 0;
+    size_t end;
+    while (!connection.closing && connection.output.size() < MAX_OUTPUT &&
+           (end = connection.input.find('\n', start)) != string::npos) {
+        string line = connection.input.substr(start, end - start);
+        if (!line.empty() && line.back() == '\r') line.pop_back();
+        if (!line.empty()) handleLine(connection, line);
+        start = end + 1;
+    }
+    connection.input.erase(0, start);
+}
+
+// Reads and answers lines a chunk at a time, so neither a line without an end nor a flood
+// of commands can grow the buffers much past their limits. Stops at MAX_OUTPUT unsent
+// bytes; writeTo() then stops watching the socket until the client catches up.
+void GameServer::readFrom(Connection& connection) {
+    char buffer[4096];
+    while (true) {
+        handleLines(connection);
+        if (connection.closing || connection.output.size() >= MAX_OUTPUT) return;
+        if (connection.input.size() > MAX_LINE) {
+            connection.output += "ERR Line too long\n";
+            connection.closing = true;
+            return;
+        }
+
+        ssize_t received = recv(connection.fd, buffer, sizeof(buffer), 0);
+        if (received > 0) {
+            connection.input.append(buffer, static_cast<size_t>(received));
+        } else if (received < 0 && errno == EINTR) {
+            continue;
+        } else {
+            // Peer closed or the connection failed; what it sent has been answered.
+            if (received == 0 || (errno != EAGAIN && errno != EWOULDBLOCK)) connection.closing = true;
+            return;
+        }
+    }
+}
+
+// Sends as much queued output as the socket takes; waits for EPOLLOUT for the rest.
+void GameServer::writeTo(Connection& connection) {
+    size_t sent = 0;
+    while (sent < connection.output.size()) {
+        ssize_t count = send(connection.fd, connection.output.data() + sent, connection.output.size() - sent, MSG_NOSIGNAL);
+        if (count > 0) {
+            sent += static_cast<size_t>(count);
+        } else if (count < 0 && errno == EINTR) {
+            continue;
+        } else {
+            if (count < 0 && errno != EAGAIN && errno != EWOULDBLOCK) {
+                connection.output.clear();
+                connection.closing = true;
+                return;
+            }
+            break;
+        }
+    }
+    connection.output.erase(0, sent);
+
+    // Only touch the interest set when it changes, so a normal reply costs one send().
+    uint32_t interest = 0;
+    if (!connection.closing && connection.output.size() < MAX_OUTPUT) interest = EPOLLIN | EPOLLRDHUP;
+    if (!connection.output.empty() || connection.closing) interest |= EPOLLOUT;
+    if (interest != connection.interest) {
+        epoll_event event = {};
+        event.events = interest;
+        event.data.fd = connection.fd;
+        epoll_ctl(epollFd, EPOLL_CTL_MOD, connection.fd, &event);
+        connection.interest = interest;
+    }
+}
+
+// Closes a connection, parking its game if one is still in progress.
+void GameServer::closeConnection(int fd) {
+    auto found = connections.find(fd);
+    if (found != connections.end()) {
+        const Connection& connection = *found->second;
+        if (connection.session.isActive() && parked.size() < MAX_PARKED) {
+            parked[connection.token] = {connection.session.getPlayerName(), connection.session.save()};
+        }
+    }
+    epoll_ctl(epollFd, EPOLL_CTL_DEL, fd, nullptr);
+    close(fd);
+    connections.erase(fd);
+    if (acceptPaused) watchListener(true);
+}
+
+// Serves connections until stop() is called.
+void GameServer::run() {
+    if (epollFd < 0) return;
+    running = true;
+    epoll_event events[256];
+    while (running) {
+        int ready = epoll_wait(epollFd, events, 256, 500);
+        if (ready < 0 && errno != EINTR) break;
+        if (ready == 0) {
+            if (journal) journal->flush(); // Idle: write out what was recorded.
+            if (acceptPaused) watchListener(true);
+        }
+        for (int i = 0; i < ready; i++) {
+            int fd = events[i].data.fd;
+            if (fd == listenFd) {
+                acceptConnections();
+                continue;
+            }
+            auto found = connections.find(fd);
+            if (found == connections.end()) continue;
+            Connection& connection = *found->second;
+
+            if (!connection.closing && (events[i].events & (EPOLLIN | EPOLLRDHUP | EPOLLHUP | EPOLLERR))) {
+                readFrom(connection);
+            }
+            if (events[i].events & (EPOLLHUP | EPOLLERR)) {
+                closeConnection(fd); // Nothing more can be sent.
+                continue;
+            }
+            if (!connection.output.empty()) writeTo(connection);
+            if (!connection.closing && connection.output.size() < MAX_OUTPUT &&
+                connection.input.find('\n') != string::npos) {
+                // Its replies drained: answer the commands held back meanwhile.
+                readFrom(connection);
+                if (!connection.output.empty()) writeTo(connection);
+            }
+            if (connection.closing && connection.output.empty()) closeConnection(fd);
+        }
+    }
+}
+
+#else
+
+bool GameServer::startListening(int) { return false; }
+bool GameServer::listenTcp(int) { return false; }
+bool GameServer::listenUnix(const string&) { return false; }
+void GameServer::acceptConnections() {}
+void GameServer::watchListener(bool) {}
+void GameServer::readFrom(Connection&) {}
+void GameServer::writeTo(Connection&) {}
+void GameServer::closeConnection(int) {}
+void GameServer::run() {}
+
+#endif
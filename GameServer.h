@@ -0,0 +1,97 @@
+#ifndef GAME_SERVER_H
+#define GAME_SERVER_H
+
+#include "GameSession.h"
+#include "Leaderboard.h"
+#include "MoveJournal.h"
+#include "PuzzlePool.h"
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <random>
+#include <string>
+#include <unordered_map>
+using namespace std;
+
+// Headless server hosting many GameSessions on one thread with an epoll event loop
+// (Linux only). Each connection is one session speaking a line protocol:
+//
+//   NEW <name> <difficulty>   -> OK <board> <token>
+//   RESUME <name> <token>     -> OK <board> <score> <seconds> <token>
+//   MOVE <row> <col> <value>  -> OK <score> | SOLVED <score> <bonus> <seconds>
+//   DEL <row> <col>           -> OK <score>
+//   HINT                      -> HINT <row> <col> <value> <score> <technique>
+//   BOARD                     -> BOARD <board> <score> <seconds>
+//   QUIT                      -> BYE, then the connection is closed
+//
+// Rows and columns are 1-based; a board is 81 characters with '.' for empty cells.
+// A rejected command answers "ERR <reason>". When a connection with a game in progress
+// closes, the game is parked as a GameSnapshot until RESUME names the player together with
+// the game's resume token. Tokens are random, handed out only to the connection playing
+// the game, and replaced on every NEW and RESUME. A connection that stops reading its
+// replies is not read from either until they drain; one sending an overlong line is dropped.
+// With a MoveJournal, every session's games and commands are recorded.
+class GameServer {
+private:
+    struct Connection {
+        int fd;
+        string input;
+        string output;
+        bool closing;
+        uint32_t interest;  // Events currently registered with epoll.
+        GameSession session;
+        string token;       // Resumes the session's game if the connection closes.
+
+        Connection(int socket, PuzzlePool& pool, Leaderboard* leaderboard);
+    };
+
+    struct ParkedGame {
+        string name;
+        GameSnapshot snapshot;
+    };
+
+    static const size_t MAX_LINE = 1024;
+    static const size_t MAX_OUTPUT = 64 * 1024; // Unsent replies before a connection stops being read.
+    static const size_t MAX_PARKED = 100000;   // About 16 MB of snapshots.
+
+    PuzzlePool& puzzlePool;
+    Leaderboard& leaderboard;
+    MoveJournal* journal;
+    int listenFd;
+    int epollFd;
+    bool acceptPaused;  // Out of descriptors: listenFd is not watched until a session closes.
+    atomic<bool> running;
+    unordered_map<int, unique_ptr<Connection>> connections;
+    unordered_map<string, ParkedGame> parked;   // By resume token.
+    random_device entropy;
+    long long commandCount;
+
+    bool startListening(int socket);
+    void acceptConnections();
+    void watchListener(bool watch);
+    void readFrom(Connection& connection);
+    void writeTo(Connection& connection);
+    void closeConnection(int fd);
+    void handleLine(Connection& connection, const string& line);
+    void handleLines(Connection& connection);
+    string newToken();
+
+public:
+    GameServer(PuzzlePool& pool, Leaderboard& results, MoveJournal* moves = nullptr);
+    ~GameServer();
+    GameServer(const GameServer&) = delete;
+    GameServer& operator=(const GameServer&) = delete;
+
+    bool listenTcp(int port);
+    bool listenUnix(const string& path);
+    void run();
+    void stop();
+
+    size_t sessionCount() const;
+    size_t parkedCount() const;
+    long long getCommandCount() const;
+
+    static bool isSupported();
+};
+
+#endif
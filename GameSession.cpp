@@ -0,0 +1,196 @@
+#include "GameSession.h"
+#include <algorithm>
+#include <exception>
+using namespace std;
+
+GameSession::GameSession(PuzzlePool& pool, Leaderboard* results)
+    : puzzlePool(pool),
+    leaderboard(results),
+    journal(nullptr),
+    journalSession(0),
+    difficulty(0),
+    score(0),
+    active(false),
+    finished(false),
+    startTime(chrono::steady_clock::now()),
+    finalSeconds(0) {}
+
+// Records every game and applied command from now on; nullptr stops recording.
+void GameSession::setJournal(MoveJournal* moves) {
+    journal = moves;
+}
+
+// Builds a result for a command that was not applied.
+GameResult GameSession::rejected(const string& error) {
+    GameResult result;
+    result.ok = false;
+    result.error = error;
+    return result;
+}
+
+// Nicknames are 3-20 characters without whitespace, so they fit the leaderboard records.
+bool GameSession::isValidName(const string& name) {
+    return name.length() >= 3 && name.length() <= 20 && name.find_first_of(" \t\r\n") == string::npos;
+}
+
+// Starts a new game for the player with a pre-generated puzzle.
+GameResult GameSession::newGame(const string& name, int level) {
+    if (!isValidName(name)) return rejected("Nickname must be 3-20 characters without spaces");
+    if (level < 1 || level > PuzzlePool::DIFFICULTIES) return rejected("Difficulty must be between 1 and 4");
+
+    playerName = name;
+    difficulty = level;
+    board = puzzlePool.take(difficulty);
+    hints.reset(board);
+    score = difficulty * 100; // Base score based on difficulty.
+    active = true;
+    finished = false;
+    startTime = chrono::steady_clock::now();
+    finalSeconds = 0;
+    if (journal) journalSession = journal->startSession(save());
+
+    GameResult result;
+    result.score = score;
+    return result;
+}
+
+// Places a number (0-based row and column). Finishing the puzzle ends the game,
+// adds the time bonus and records the score.
+GameResult GameSession::move(int row, int col, int value) {
+    if (!active) return rejected("No game in progress");
+    try {
+        board.makeMove(row, col, value);
+    } catch (const exception& e) {
+        return rejected(e.what());
+    }
+    hints.cellChanged(board, row, col);
+    if (journal) journal->record(journalSession, MoveJournal::MOVE, row, col, value);
+
+    GameResult result;
+    result.row = row;
+    result.col = col;
+    result.value = value;
+    if (board.isSolved()) {
+        finalSeconds = elapsedSeconds();
+        active = false;
+        finished = true;
+
+        result.solved = true;
+        result.timeBonus = max(0, 300 - finalSeconds) / 10 * difficulty; // Bonus for solving under 5 minutes.
+        score += result.timeBonus;
+        if (leaderboard) leaderboard->addResult(playerName, score);
+    }
+    result.score = score;
+    result.seconds = elapsedSeconds();
+    return result;
+}
+
+// Clears a number the player entered (0-based row and column).
+GameResult GameSession::erase(int row, int col) {
+    if (!active) return rejected("No game in progress");
+    try {
+        board.deleteMove(row, col);
+    } catch (const exception& e) {
+        return rejected(e.what());
+    }
+    hints.cellChanged(board, row, col);
+    if (journal) journal->record(journalSession, MoveJournal::ERASE, row, col, 0);
+
+    GameResult result;
+    result.row = row;
+    result.col = col;
+    result.score = score;
+    return result;
+}
+
+// Suggests the next logical placement (or corrects a mistake), at a cost of HINT_PENALTY points.
+GameResult GameSession::hint() {
+    if (!active) return rejected("No game in progress");
+    HintEngine::Hint found = hints.findHint(board);
+    if (found.technique == HintEngine::NONE) return rejected("No empty cells left");
+
+    score -= HINT_PENALTY;
+    if (journal) journal->record(journalSession, MoveJournal::HINT, found.row, found.col, found.value);
+    GameResult result;
+    result.row = found.row;
+    result.col = found.col;
+    result.value = found.value;
+    result.technique = HintEngine::techniqueName(found.technique);
+    result.score = score;
+    return result;
+}
+
+// Packs the game in progress, so it can be parked or written to disk and resumed later.
+GameSnapshot GameSession::save() const {
+    return GameSnapshot::capture(board, difficulty, score, elapsedSeconds());
+}
+
+// Continues a saved game for the player; the timer picks up where it stopped.
+GameResult GameSession::resume(const string& name, const GameSnapshot& snapshot) {
+    if (!isValidName(name)) return rejected("Nickname must be 3-20 characters without spaces");
+    if (snapshot.difficulty < 1 || snapshot.difficulty > PuzzlePool::DIFFICULTIES) return rejected("Saved game is damaged");
+    try {
+        snapshot.restore(board);
+    } catch (const exception& e) {
+        return rejected(e.what());
+    }
+
+    playerName = name;
+    difficulty = snapshot.difficulty;
+    hints.reset(board);
+    score = snapshot.score;
+    active = !board.isSolved();
+    finished = !active;
+    startTime = chrono::steady_clock::now() - chrono::seconds(snapshot.seconds);
+    finalSeconds = static_cast<int>(snapshot.seconds);
+    if (journal) journalSession = journal->startSession(snapshot);
+
+    GameResult result;
+    result.score = score;
+    result.seconds = finalSeconds;
+    return result;
+}
+
+bool GameSession::isActive() const {
+    return active;
+}
+
+const SudokuBoard& GameSession::getBoard() const {
+    return board;
+}
+
+const string& GameSession::getPlayerName() const {
+    return playerName;
+}
+
+int GameSession::getDifficulty() const {
+    return difficulty;
+}
+
+int GameSession::getScore() const {
+    return score;
+}
+
+// Seconds since the game started; frozen once the puzzle is solved.
+int GameSession::elapsedSeconds() const {
+    if (finished) return finalSeconds;
+    return static_cast<int>(chrono::duration_cast<chrono::seconds>(chrono::steady_clock::now() - startTime).count());
+}
+
+// When the clock started; elapsedSeconds() counts whole seconds from here.
+chrono::steady_clock::time_point GameSession::getStartTime() const {
+    return startTime;
+}
+
+// The board as 81 characters in row-major order, '.' for empty cells.
+string GameSession::boardString() const {
+    string cells;
+    cells.reserve(SudokuBoard::CELLS);
+    for (int row = 0; row < SudokuBoard::SIZE; row++) {
+        for (int col = 0; col < SudokuBoard::SIZE; col++) {
+            int value = board.getValue(row, col);
+            cells += value ? static_cast<char>('0' + value) : '.';
+        }
+    }
+    return cells;
+}
@@ -0,0 +1,75 @@
+#ifndef GAME_SESSION_H
+#define GAME_SESSION_H
+
+#include "SudokuBoard.h"
+#include "Leaderboard.h"
+#include "PuzzlePool.h"
+#include "HintEngine.h"
+#include "GameSnapshot.h"
+#include "MoveJournal.h"
+#include <chrono>
+#include <string>
+using namespace std;
+
+// Outcome of one session command. `ok` is false when the command was rejected,
+// with the reason in `error`.
+struct GameResult {
+    bool ok = true;
+    bool solved = false;
+    int row = -1;
+    int col = -1;
+    int value = 0;
+    int score = 0;
+    int timeBonus = 0;
+    int seconds = 0;
+    string technique;   // How a hint was found.
+    string error;
+};
+
+// One player's game, independent of any terminal: it takes commands and returns
+// results. The console and the network server both drive the game through it.
+class GameSession {
+private:
+    PuzzlePool& puzzlePool;
+    Leaderboard* leaderboard;
+    MoveJournal* journal;
+    uint32_t journalSession;
+
+    SudokuBoard board;
+    HintEngine hints;
+    string playerName;
+    int difficulty;
+    int score;
+    bool active;
+    bool finished;
+    chrono::time_point<chrono::steady_clock> startTime;
+    int finalSeconds;
+
+    static GameResult rejected(const string& error);
+
+public:
+    static const int HINT_PENALTY = 5;
+
+    explicit GameSession(PuzzlePool& pool, Leaderboard* results = nullptr);
+
+    void setJournal(MoveJournal* moves);
+
+    static bool isValidName(const string& name);
+    GameResult newGame(const string& name, int level);
+    GameResult move(int row, int col, int value);
+    GameResult erase(int row, int col);
+    GameResult hint();
+    GameSnapshot save() const;
+    GameResult resume(const string& name, const GameSnapshot& snapshot);
+
+    bool isActive() const;
+    const SudokuBoard& getBoard() const;
+    const string& getPlayerName() const;
+    int getDifficulty() const;
+    int getScore() const;
+    int elapsedSeconds() const;
+    chrono::steady_clock::time_point getStartTime() const;
+    string boardString() const;
+};
+
+#endif
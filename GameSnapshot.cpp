@@ -0,0 +1,69 @@
+#include "GameSnapshot.h"
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+using namespace std;
+
+static const char MAGIC[4] = {'S', 'D', 'K', 'S'};
+
+// Packs the board, its solution and givens together with the game state.
+GameSnapshot GameSnapshot::capture(const SudokuBoard& board, int difficulty, int score, int seconds) {
+    GameSnapshot snapshot;
+    memset(&snapshot, 0, sizeof(snapshot));
+    memcpy(snapshot.magic, MAGIC, sizeof(MAGIC));
+    snapshot.version = VERSION;
+    snapshot.difficulty = static_cast<uint8_t>(difficulty);
+    snapshot.score = score;
+    snapshot.seconds = static_cast<uint32_t>(seconds < 0 ? 0 : seconds);
+
+    const SudokuBoard::Grid& cells = board.getCells();
+    const SudokuBoard::Grid& answer = board.getSolution();
+    const auto& given = board.getGivens();
+    for (int cell = 0; cell < SudokuBoard::CELLS; cell++) {
+        int shift = (cell & 1) * 4;
+        snapshot.cells[cell / 2] |= static_cast<uint8_t>(cells[cell] << shift);
+        snapshot.solution[cell / 2] |= static_cast<uint8_t>(answer[cell] << shift);
+        if (given[cell]) snapshot.givens[cell / 8] |= static_cast<uint8_t>(1 << (cell % 8));
+    }
+    return snapshot;
+}
+
+// Unpacks into `board`. The board checks the data while rebuilding its masks, so a
+// damaged or forged snapshot throws invalid_argument and leaves the board as it was.
+void GameSnapshot::restore(SudokuBoard& board) const {
+    if (memcmp(magic, MAGIC, sizeof(MAGIC)) != 0 || version != VERSION) {
+        throw invalid_argument("Not a saved game");
+    }
+
+    SudokuBoard::Grid unpackedCells;
+    SudokuBoard::Grid unpackedSolution;
+    bitset<SudokuBoard::CELLS> unpackedGivens;
+    for (int cell = 0; cell < SudokuBoard::CELLS; cell++) {
+        int shift = (cell & 1) * 4;
+        unpackedCells[cell] = (cells[cell / 2] >> shift) & 0xF;
+        unpackedSolution[cell] = (solution[cell / 2] >> shift) & 0xF;
+        unpackedGivens[cell] = (givens[cell / 8] >> (cell % 8)) & 1;
+    }
+    board.load(unpackedCells, unpackedSolution, unpackedGivens);
+}
+
+// Writes to a temporary file and renames it over `path`, so a crash never leaves half a save.
+bool GameSnapshot::writeFile(const string& path, const GameSnapshot& snapshot) {
+    string temporary = path + ".tmp";
+    {
+        ofstream file(temporary, ios::binary | ios::trunc);
+        if (!file.write(reinterpret_cast<const char*>(&snapshot), sizeof(snapshot))) return false;
+    }
+    error_code error;
+    filesystem::rename(temporary, path, error);
+    return !error;
+}
+
+// Reads a snapshot back. Returns false if the file is missing or not exactly one snapshot long;
+// the contents are checked by restore().
+bool GameSnapshot::readFile(const string& path, GameSnapshot& snapshot) {
+    ifstream file(path, ios::binary);
+    if (!file.read(reinterpret_cast<char*>(&snapshot), sizeof(snapshot))) return false;
+    return file.peek() == ifstream::traits_type::eof();
+}
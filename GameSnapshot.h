@@ -0,0 +1,38 @@
+#ifndef GAME_SNAPSHOT_H
+#define GAME_SNAPSHOT_H
+
+#include "SudokuBoard.h"
+#include <cstdint>
+#include <string>
+#include <type_traits>
+using namespace std;
+
+// A 9x9 game in progress packed into 108 bytes: the board and the solution at 4 bits per
+// cell, the givens as a bitmask, then the timer, score and difficulty. The layout is fixed
+// and pointer-free, so a snapshot is saved and loaded as one block with no text parsing.
+// The player's name is not part of it; callers keep snapshots under the name.
+struct GameSnapshot {
+    static constexpr int PACKED_CELLS = (SudokuBoard::CELLS + 1) / 2;
+    static constexpr int GIVEN_BYTES = (SudokuBoard::CELLS + 7) / 8;
+    static constexpr uint8_t VERSION = 1;
+
+    char magic[4];
+    int32_t score;
+    uint32_t seconds;
+    uint8_t version;
+    uint8_t difficulty;
+    uint8_t cells[PACKED_CELLS];       // Two cells per byte, the lower-numbered one in the low nibble.
+    uint8_t solution[PACKED_CELLS];
+    uint8_t givens[GIVEN_BYTES];       // Bit i % 8 of byte i / 8 is cell i.
+
+    static GameSnapshot capture(const SudokuBoard& board, int difficulty, int score, int seconds);
+    void restore(SudokuBoard& board) const;
+
+    static bool writeFile(const string& path, const GameSnapshot& snapshot);
+    static bool readFile(const string& path, GameSnapshot& snapshot);
+};
+
+static_assert(is_trivially_copyable<GameSnapshot>::value, "snapshots are copied as raw bytes");
+static_assert(sizeof(GameSnapshot) == 108, "snapshot layout changed; bump VERSION");
+
+#endif // GAME_SNAPSHOT_H
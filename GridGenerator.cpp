@@ -0,0 +1,129 @@
+#include "GridGenerator.h"
+#include "BitUtils.h"
+using namespace std;
+
+template <int BOX>
+BasicGridGenerator<BOX>::BasicGridGenerator() {}
+
+// Constructor: A fixed seed makes the sequence of grids reproducible.
+template <int BOX>
+BasicGridGenerator<BOX>::BasicGridGenerator(uint64_t seed) : rng(seed) {}
+
+template <int BOX>
+inline void BasicGridGenerator<BOX>::place(State& state, int cell, int num) const {
+    const auto& tables = gridTables<BOX>;
+    Mask bit = Mask(1) << (num - 1);
+    state.cells[cell] = num;
+    state.rowUsed[tables.rowOf[cell]] |= bit;
+    state.colUsed[tables.colOf[cell]] |= bit;
+    state.boxUsed[tables.boxOf[cell]] |= bit;
+}
+
+template <int BOX>
+inline void BasicGridGenerator<BOX>::unplace(State& state, int cell, int num) const {
+    const auto& tables = gridTables<BOX>;
+    Mask bit = Mask(1) << (num - 1);
+    state.cells[cell] = 0;
+    state.rowUsed[tables.rowOf[cell]] &= ~bit;
+    state.colUsed[tables.colOf[cell]] &= ~bit;
+    state.boxUsed[tables.boxOf[cell]] &= ~bit;
+}
+
+// Number of candidates in a mask; this runs for every empty cell at every node.
+template <int BOX>
+inline int BasicGridGenerator<BOX>::countOf(Mask mask) {
+    if constexpr (SIZE <= SMALL_MASK_BITS) {
+        return smallBitCount(mask);
+    } else {
+        return bitCount(mask);
+    }
+}
+
+// Fills the empty cells in place, most constrained cell first. Gives up when `budget`
+// nodes are spent, so a rare dead-end start costs a restart rather than a long search.
+template <int BOX>
+bool BasicGridGenerator<BOX>::fill(State& state, long long& budget) {
+    if (state.emptyCount == 0) return true;
+
+    const auto& tables = gridTables<BOX>;
+    int best = 0;
+    int bestCount = SIZE + 1;
+    Mask bestMask = 0;
+    for (int i = 0; i < state.emptyCount; i++) {
+        int cell = state.empty[i];
+        Mask mask = Traits::ALL_DIGITS & ~(state.rowUsed[tables.rowOf[cell]] |
+                                           state.colUsed[tables.colOf[cell]] |
+                                           state.boxUsed[tables.boxOf[cell]]);
+        int count = countOf(mask);
+        if (count < bestCount) {
+            best = i;
+            bestCount = count;
+            bestMask = mask;
+            if (count <= 1) break;
+        }
+    }
+    if (bestCount == 0 || --budget < 0) return false;
+
+    // Take the cell off the empty list (swapped with the last entry, undone below).
+    int last = --state.emptyCount;
+    swap(state.empty[best], state.empty[last]);
+    int cell = state.empty[last];
+
+    for (Mask left = bestMask; left; ) {
+        // Pick one of the remaining digits at random.
+        Mask pick = left;
+        for (int skip = rng.below(countOf(left)); skip > 0; skip--) pick &= pick - 1;
+        int num = lowestBit(pick) + 1;
+        left &= ~(Mask(1) << (num - 1));
+
+        place(state, cell, num);
+        if (fill(state, budget)) return true;
+        unplace(state, cell, num);
+        if (budget < 0) break;
+    }
+
+    swap(state.empty[best], state.empty[last]);
+    state.emptyCount++;
+    return false;
+}
+
+// Writes a uniformly shuffled start plus a random completion of it into `grid`.
+template <int BOX>
+void BasicGridGenerator<BOX>::generate(Grid& grid) {
+    State state;
+    while (true) {
+        state.cells.fill(0);
+        for (int i = 0; i < SIZE; i++) {
+            state.rowUsed[i] = state.colUsed[i] = state.boxUsed[i] = 0;
+        }
+
+        // Boxes on the diagonal share no row or column, so any digit order works for each.
+        for (int d = 0; d < BOX; d++) {
+            int digits[SIZE];
+            for (int i = 0; i < SIZE; i++) digits[i] = i + 1;
+            for (int i = SIZE - 1; i > 0; i--) swap(digits[i], digits[rng.below(i + 1)]);
+            for (int i = 0; i < SIZE; i++) {
+                int cell = (d * BOX + i / BOX) * SIZE + d * BOX + i % BOX;
+                place(state, cell, digits[i]);
+            }
+        }
+
+        state.emptyCount = 0;
+        for (int cell = 0; cell < CELLS; cell++) {
+            if (state.cells[cell] == 0) state.empty[state.emptyCount++] = cell;
+        }
+        long long budget = 4LL * CELLS;
+        if (fill(state, budget)) break;
+    }
+    grid = state.cells;
+}
+
+// The generator's PRNG, for callers that want more randomness from the same stream.
+template <int BOX>
+Xoshiro256& BasicGridGenerator<BOX>::random() {
+    return rng;
+}
+
+template class BasicGridGenerator<3>;
+template class BasicGridGenerator<4>;
+template class BasicGridGenerator<5>;
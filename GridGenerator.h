@@ -0,0 +1,48 @@
+#ifndef GRID_GENERATOR_H
+#define GRID_GENERATOR_H
+
+#include "GridTraits.h"
+#include "Random.h"
+
+// Samples random complete grids: the diagonal boxes (which never see each other) are
+// shuffled outright, then a bitmask search fills the rest, taking the most constrained
+// cell first and trying its digits in random order. Each generator owns its PRNG, so one
+// per thread scales without locking.
+template <int BOX>
+class BasicGridGenerator {
+public:
+    using Traits = GridTraits<BOX>;
+    using Grid = typename Traits::Grid;
+    using Mask = typename Traits::Mask;
+
+    static constexpr int SIZE = Traits::SIZE;
+    static constexpr int CELLS = Traits::CELLS;
+
+private:
+    struct State {
+        Grid cells;
+        Mask rowUsed[SIZE];
+        Mask colUsed[SIZE];
+        Mask boxUsed[SIZE];
+        typename Traits::CellIndex empty[CELLS];   // Empty cells, in no particular order.
+        int emptyCount;
+    };
+
+    Xoshiro256 rng;
+
+    static int countOf(Mask mask);
+    void place(State& state, int cell, int num) const;
+    void unplace(State& state, int cell, int num) const;
+    bool fill(State& state, long long& budget);
+
+public:
+    BasicGridGenerator();
+    explicit BasicGridGenerator(uint64_t seed);
+
+    void generate(Grid& grid);
+    Xoshiro256& random();
+};
+
+using GridGenerator = BasicGridGenerator<3>;
+
+#endif // GRID_GENERATOR_H
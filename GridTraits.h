@@ -0,0 +1,89 @@
+#ifndef GRID_TRAITS_H
+#define GRID_TRAITS_H
+
+#include <array>
+#include <cstdint>
+#include <type_traits>
+
+// Compile-time geometry of a Sudoku grid with BOX x BOX boxes (BOX = 3 is the classic 9x9).
+// Everything here is constexpr so each size gets its own fully specialized engine.
+template <int BOX>
+struct GridTraits {
+    static_assert(BOX >= 2 && BOX <= 5, "supported grids are 4x4 up to 25x25");
+
+    static constexpr int SUBGRID_SIZE = BOX;
+    static constexpr int SIZE = BOX * BOX;
+    static constexpr int CELLS = SIZE * SIZE;
+    static constexpr int UNITS = 3 * SIZE;
+    static constexpr int PEERS = 2 * (SIZE - 1) + (BOX - 1) * (BOX - 1);
+
+    // One bit per digit: 16 bits are enough up to 16x16, 25x25 needs 32.
+    using Mask = typename std::conditional<(SIZE <= 16), uint16_t, uint32_t>::type;
+    static constexpr Mask ALL_DIGITS = static_cast<Mask>((1u << SIZE) - 1);
+
+    using Grid = std::array<uint8_t, CELLS>;
+    // Smallest type that can index every cell (keeps the 9x9 tables byte-sized).
+    using CellIndex = typename std::conditional<(CELLS <= 256), uint8_t, uint16_t>::type;
+
+    // Puzzle text writes digits 1-9 as themselves and 10 upward as letters from 'A' ('G'
+    // is 16, 'P' is 25); '.' or '0' is an empty cell. Returns -1 for any other character.
+    static constexpr int digitOf(char c) {
+        if (c == '.' || c == '0') return 0;
+        if (c >= '1' && c <= '9') return c - '0' <= SIZE ? c - '0' : -1;
+        if (c >= 'A' && c <= 'Z') return c - 'A' + 10 <= SIZE ? c - 'A' + 10 : -1;
+        return -1;
+    }
+    static constexpr char symbolOf(int digit) {
+        return digit == 0 ? '.' : digit <= 9 ? static_cast<char>('0' + digit) : static_cast<char>('A' + digit - 10);
+    }
+
+    static constexpr int rowOf(int cell) { return cell / SIZE; }
+    static constexpr int colOf(int cell) { return cell % SIZE; }
+    static constexpr int boxOf(int row, int col) { return (row / BOX) * BOX + col / BOX; }
+
+    struct Tables {
+        uint8_t rowOf[CELLS];
+        uint8_t colOf[CELLS];
+        uint8_t boxOf[CELLS];
+        CellIndex units[UNITS][SIZE];   // Rows, then columns, then boxes.
+        CellIndex peers[CELLS][PEERS];  // Every other cell sharing a row, column or box.
+    };
+
+    static constexpr Tables makeTables() {
+        Tables t{};
+        for (int cell = 0; cell < CELLS; cell++) {
+            int row = rowOf(cell);
+            int col = colOf(cell);
+            int box = boxOf(row, col);
+            t.rowOf[cell] = row;
+            t.colOf[cell] = col;
+            t.boxOf[cell] = box;
+            t.units[row][col] = cell;
+            t.units[SIZE + col][row] = cell;
+            t.units[2 * SIZE + box][(row % BOX) * BOX + col % BOX] = cell;
+        }
+
+        for (int cell = 0; cell < CELLS; cell++) {
+            int row = rowOf(cell);
+            int col = colOf(cell);
+            int count = 0;
+            for (int i = 0; i < SIZE; i++) {
+                if (i != col) t.peers[cell][count++] = row * SIZE + i;
+                if (i != row) t.peers[cell][count++] = i * SIZE + col;
+            }
+            int boxRow = row - row % BOX;
+            int boxCol = col - col % BOX;
+            for (int r = boxRow; r < boxRow + BOX; r++) {
+                for (int c = boxCol; c < boxCol + BOX; c++) {
+                    if (r != row && c != col) t.peers[cell][count++] = r * SIZE + c;
+                }
+            }
+        }
+        return t;
+    }
+};
+
+template <int BOX>
+inline constexpr typename GridTraits<BOX>::Tables gridTables = GridTraits<BOX>::makeTables();
+
+#endif // GRID_TRAITS_H
@@ -0,0 +1,268 @@
+#include "HintEngine.h"
+#include "BitUtils.h"
+#include <algorithm>
+using namespace std;
+
+namespace {
+
+using Traits = SudokuBoard::Traits;
+constexpr int SIZE = Traits::SIZE;
+constexpr int CELLS = Traits::CELLS;
+constexpr int BOX = Traits::SUBGRID_SIZE;
+constexpr const auto& TABLES = gridTables<BOX>;
+
+// Unit indices in the tables: rows, then columns, then boxes.
+constexpr int ROW_UNIT = 0;
+constexpr int COL_UNIT = SIZE;
+constexpr int BOX_UNIT = 2 * SIZE;
+
+} // namespace
+
+HintEngine::HintEngine() {
+    candidates.fill(0);
+}
+
+// Rebuilds every cell's candidates, e.g. when a new puzzle starts.
+void HintEngine::reset(const SudokuBoard& board) {
+    for (int cell = 0; cell < CELLS; cell++) {
+        candidates[cell] = board.getCandidates(cell / SIZE, cell % SIZE);
+    }
+}
+
+// Updates the changed cell and its 20 peers after a move or a deletion.
+void HintEngine::cellChanged(const SudokuBoard& board, int row, int col) {
+    int cell = row * SIZE + col;
+    candidates[cell] = board.getCandidates(row, col);
+    for (int peer : TABLES.peers[cell]) {
+        candidates[peer] = board.getCandidates(peer / SIZE, peer % SIZE);
+    }
+}
+
+const HintEngine::Candidates& HintEngine::getCandidates() const {
+    return candidates;
+}
+
+// Places a value in a candidate grid: the cell is done and its peers lose the value.
+void HintEngine::place(Candidates& cells, int cell, int value) {
+    Mask bit = Mask(1) << (value - 1);
+    cells[cell] = 0;
+    for (int peer : TABLES.peers[cell]) cells[peer] &= ~bit;
+}
+
+// Finds a naked single (a cell with one candidate), then a hidden single
+// (a digit with one place left in a row, column or box).
+bool HintEngine::findSingle(const Candidates& cells, Hint& hint) {
+    for (int cell = 0; cell < CELLS; cell++) {
+        if (isSingleBit(cells[cell])) {
+            hint = {cell / SIZE, cell % SIZE, lowestBit(cells[cell]) + 1, NAKED_SINGLE};
+            return true;
+        }
+    }
+
+    for (int unit = 0; unit < Traits::UNITS; unit++) {
+        Mask seen = 0, repeated = 0;
+        for (int cell : TABLES.units[unit]) {
+            repeated |= seen & cells[cell];
+            seen |= cells[cell];
+        }
+        Mask once = seen & ~repeated;
+        if (!once) continue;
+        for (int cell : TABLES.units[unit]) {
+            if (cells[cell] & once) {
+                hint = {cell / SIZE, cell % SIZE, lowestBit(cells[cell] & once) + 1, HIDDEN_SINGLE};
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+// Pointing and claiming: when a digit's places in one unit all lie in a second unit,
+// it can be removed from the rest of that second unit.
+bool HintEngine::lockedCandidates(Candidates& cells) {
+    bool changed = false;
+    for (int box = 0; box < SIZE; box++) {
+        for (int line = 0; line < 2 * SIZE; line++) {
+            // Only lines crossing the box matter.
+            bool isRow = line < SIZE;
+            int index = isRow ? line : line - SIZE;
+            if (index / BOX != (isRow ? box / BOX : box % BOX)) continue;
+
+            Mask inside = 0, boxRest = 0, lineRest = 0;
+            for (int cell : TABLES.units[BOX_UNIT + box]) {
+                bool onLine = isRow ? cell / SIZE == index : cell % SIZE == index;
+                (onLine ? inside : boxRest) |= cells[cell];
+            }
+            for (int cell : TABLES.units[line]) {
+                if (TABLES.boxOf[cell] != box) lineRest |= cells[cell];
+            }
+
+            Mask pointing = inside & ~boxRest & lineRest;   // Box digit confined to the line.
+            Mask claiming = inside & ~lineRest & boxRest;   // Line digit confined to the box.
+            if (pointing) {
+                for (int cell : TABLES.units[line]) {
+                    if (TABLES.boxOf[cell] != box) cells[cell] &= ~pointing;
+                }
+                changed = true;
+            }
+            if (claiming) {
+                for (int cell : TABLES.units[BOX_UNIT + box]) {
+                    bool onLine = isRow ? cell / SIZE == index : cell % SIZE == index;
+                    if (!onLine) cells[cell] &= ~claiming;
+                }
+                changed = true;
+            }
+            if (changed) return true;
+        }
+    }
+    return false;
+}
+
+// Two cells of a unit with the same two candidates own those digits in that unit.
+bool HintEngine::nakedPairs(Candidates& cells) {
+    for (int unit = 0; unit < Traits::UNITS; unit++) {
+        const auto& members = TABLES.units[unit];
+        for (int i = 0; i < SIZE; i++) {
+            Mask pair = cells[members[i]];
+            if (bitCount(pair) != 2) continue;
+            for (int j = i + 1; j < SIZE; j++) {
+                if (cells[members[j]] != pair) continue;
+                bool changed = false;
+                for (int k = 0; k < SIZE; k++) {
+                    int cell = members[k];
+                    if (k != i && k != j && (cells[cell] & pair)) {
+                        cells[cell] &= ~pair;
+                        changed = true;
+                    }
+                }
+                if (changed) return true;
+            }
+        }
+    }
+    return false;
+}
+
+// Two digits confined to the same two cells of a unit leave no room for anything else there.
+bool HintEngine::hiddenPairs(Candidates& cells) {
+    for (int unit = 0; unit < Traits::UNITS; unit++) {
+        const auto& members = TABLES.units[unit];
+        uint16_t places[SIZE] = {};   // Positions within the unit, per digit.
+        for (int k = 0; k < SIZE; k++) {
+            for (Mask digits = cells[members[k]]; digits; digits &= digits - 1) {
+                places[lowestBit(digits)] |= uint16_t(1) << k;
+            }
+        }
+        for (int a = 0; a < SIZE; a++) {
+            if (bitCount(places[a]) != 2) continue;
+            for (int b = a + 1; b < SIZE; b++) {
+                if (places[b] != places[a]) continue;
+                Mask pair = static_cast<Mask>((1u << a) | (1u << b));
+                bool changed = false;
+                for (uint16_t positions = places[a]; positions; positions &= positions - 1) {
+                    int cell = members[lowestBit(positions)];
+                    if (cells[cell] != pair) {
+                        cells[cell] = pair;
+                        changed = true;
+                    }
+                }
+                if (changed) return true;
+            }
+        }
+    }
+    return false;
+}
+
+// A digit with exactly two places in each of two rows, in the same two columns,
+// can be removed from the rest of those columns (and the same with rows and columns swapped).
+bool HintEngine::xWings(Candidates& cells) {
+    for (int digit = 0; digit < SIZE; digit++) {
+        Mask bit = Mask(1) << digit;
+        for (int byColumns = 0; byColumns < 2; byColumns++) {
+            uint16_t places[SIZE] = {};
+            for (int line = 0; line < SIZE; line++) {
+                const auto& members = TABLES.units[(byColumns ? COL_UNIT : ROW_UNIT) + line];
+                for (int k = 0; k < SIZE; k++) {
+                    if (cells[members[k]] & bit) places[line] |= uint16_t(1) << k;
+                }
+            }
+            for (int a = 0; a < SIZE; a++) {
+                if (bitCount(places[a]) != 2) continue;
+                for (int b = a + 1; b < SIZE; b++) {
+                    if (places[b] != places[a]) continue;
+                    bool changed = false;
+                    for (uint16_t cross = places[a]; cross; cross &= cross - 1) {
+                        const auto& crossing = TABLES.units[(byColumns ? ROW_UNIT : COL_UNIT) + lowestBit(cross)];
+                        for (int line = 0; line < SIZE; line++) {
+                            int cell = crossing[line];
+                            if (line != a && line != b && (cells[cell] & bit)) {
+                                cells[cell] &= ~bit;
+                                changed = true;
+                            }
+                        }
+                    }
+                    if (changed) return true;
+                }
+            }
+        }
+    }
+    return false;
+}
+
+// Applies the easiest elimination technique, up to `hardest`, that removes a candidate.
+bool HintEngine::eliminate(Candidates& cells, Technique hardest, Technique& used) {
+    static bool (*const techniques[])(Candidates&) = {lockedCandidates, nakedPairs, hiddenPairs, xWings};
+    for (int t = LOCKED_CANDIDATES; t <= min<int>(hardest, X_WING); t++) {
+        if (techniques[t - LOCKED_CANDIDATES](cells)) {
+            used = static_cast<Technique>(t);
+            return true;
+        }
+    }
+    return false;
+}
+
+// Eliminates until a single appears; the hint carries the hardest technique that was needed.
+HintEngine::Hint HintEngine::deduce(Candidates cells, Technique hardest) {
+    Technique needed = NAKED_SINGLE;
+    Hint hint;
+    while (true) {
+        if (findSingle(cells, hint)) {
+            hint.technique = max(hint.technique, needed);
+            return hint;
+        }
+        Technique used;
+        if (!eliminate(cells, hardest, used)) return Hint();
+        needed = max(needed, used);
+    }
+}
+
+// Returns the easiest useful hint: fix a mistake first, then a logical step, then
+// (if logic gets stuck) the solution value of the first empty cell.
+HintEngine::Hint HintEngine::findHint(const SudokuBoard& board) const {
+    const auto& wrong = board.getWrongCells();
+    if (wrong.any()) {
+        for (int cell = 0; cell < CELLS; cell++) {
+            if (wrong[cell]) return {cell / SIZE, cell % SIZE, board.getSolutionValue(cell / SIZE, cell % SIZE), MISTAKE};
+        }
+    }
+
+    Hint hint = deduce(candidates);
+    if (hint.technique != NONE) return hint;
+
+    auto cell = board.getHint();
+    if (cell.first == -1) return Hint();
+    return {cell.first, cell.second, board.getSolutionValue(cell.first, cell.second), SOLUTION};
+}
+
+const char* HintEngine::techniqueName(Technique technique) {
+    switch (technique) {
+        case NAKED_SINGLE: return "Naked Single";
+        case HIDDEN_SINGLE: return "Hidden Single";
+        case LOCKED_CANDIDATES: return "Locked Candidates";
+        case NAKED_PAIR: return "Naked Pair";
+        case HIDDEN_PAIR: return "Hidden Pair";
+        case X_WING: return "X-Wing";
+        case MISTAKE: return "Mistake";
+        case SOLUTION: return "Solution";
+        default: return "None";
+    }
+}
@@ -0,0 +1,59 @@
+#ifndef HINT_ENGINE_H
+#define HINT_ENGINE_H
+
+#include "SudokuBoard.h"
+#include <array>
+
+// Finds the next logical step on a 9x9 board, the way a person would solve it.
+// Candidate masks are kept up to date cell by cell as moves are made, so a hint
+// only runs the techniques, never a full solve.
+class HintEngine {
+public:
+    using Mask = SudokuBoard::Mask;
+    using Candidates = array<Mask, SudokuBoard::CELLS>;
+
+    // Ordered from easiest to hardest.
+    enum Technique {
+        NAKED_SINGLE,
+        HIDDEN_SINGLE,
+        LOCKED_CANDIDATES,
+        NAKED_PAIR,
+        HIDDEN_PAIR,
+        X_WING,
+        MISTAKE,    // A filled cell is wrong; the hint corrects it.
+        SOLUTION,   // No technique applies; the hint reveals the solution.
+        NONE
+    };
+
+    struct Hint {
+        int row = -1;
+        int col = -1;
+        int value = 0;
+        Technique technique = NONE;  // Hardest technique needed to reach this placement.
+    };
+
+private:
+    Candidates candidates;  // Empty cells' candidates; 0 for filled cells.
+
+    static bool lockedCandidates(Candidates& cells);
+    static bool nakedPairs(Candidates& cells);
+    static bool hiddenPairs(Candidates& cells);
+    static bool xWings(Candidates& cells);
+
+public:
+    HintEngine();
+
+    void reset(const SudokuBoard& board);
+    void cellChanged(const SudokuBoard& board, int row, int col);
+    const Candidates& getCandidates() const;
+    Hint findHint(const SudokuBoard& board) const;
+
+    // Logic core, also used by the difficulty rating.
+    static bool findSingle(const Candidates& cells, Hint& hint);
+    static bool eliminate(Candidates& cells, Technique hardest, Technique& used);
+    static Hint deduce(Candidates cells, Technique hardest = X_WING);
+    static void place(Candidates& cells, int cell, int value);
+    static const char* techniqueName(Technique technique);
+};
+
+#endif
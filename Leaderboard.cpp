@@ -2,67 +2,306 @@
 #include <fstream>
 #include <iostream>
 #include <algorithm>
+#include <filesystem>
+#include <iterator>
+#include <sstream>
+#include <vector>
 
 using namespace std;
 
 // Constructor: Initializes the leaderboard with a file and loads data from it.
-Leaderboard::Leaderboard(const string& file) : filename(file) {
+Leaderboard::Leaderboard(const string& file)
+    : filename(file), sequence(0), liveOnly(0), foldedSequence(0), logRecords(0), compacting(false), compacted(false) {
     load();
 }
 
-// Loads scores from the file into memory.
+// Waits for a running compaction and puts its snapshot in place.
+Leaderboard::~Leaderboard() {
+    if (compactor.joinable()) compactor.join();
+    finishCompaction();
+}
+
+// Loads the snapshot, then replays any unfinished compaction and the log on top of it.
 void Leaderboard::load() {
-    scores.clear(); // Ensure scores are empty before loading.
-    ifstream file(filename);
-    if (file.is_open()) {
+    byScore.clear(); // Ensure scores are empty before loading.
+    byName.clear();
+    shadowed.clear();
+    liveOnly = 0;
+    auto apply = [this](const string& name, int score) { setScore(name, score); };
+    auto applyLogged = [this](const string& name, int score) { setScore(name, score); logRecords++; };
+    if (!archive.open(filename)) {
+        readRecords(filename, apply); // Text snapshot written by older versions.
+    }
+    bool pendingCompaction = readRecords(filename + ".compacting", applyLogged);
+    foldedSequence = sequence;
+
+    string logPath = filename + ".log";
+    readRecords(logPath, applyLogged);
+    {
+        // A crash mid-append can leave a record without its newline; cut it off so
+        // the next record does not get glued onto it.
+        ifstream log(logPath, ios::binary | ios::ate);
+        streamoff end = log.is_open() ? static_cast<streamoff>(log.tellg()) : 0;
+        streamoff keep = end;
+        while (keep > 0) {
+            log.seekg(keep - 1);
+            if (log.get() == '\n') break;
+            keep--;
+        }
+        log.close();
+        error_code error;
+        if (keep < end) filesystem::resize_file(logPath, keep, error);
+    }
+    logFile.open(logPath, ios::app);
+
+    if (pendingCompaction || needsCompaction()) {
+        startCompaction();
+    }
+}
+
+// Passes every complete "name score" record in a file to `apply`. Returns false if the file is missing.
+bool Leaderboard::readRecords(const string& path, const function<void(const string&, int)>& apply) {
+    ifstream file(path);
+    if (!file.is_open()) return false;
+
+    string line;
+    while (getline(file, line)) {
+        // A final line without a newline is a torn write and is ignored.
+        if (file.eof()) break;
+        istringstream record(line);
         string name;
         int score;
-        while (file >> name >> score) {
-            // Read player names and scores line by line.
-            scores.emplace_back(name, score);
-        }
-        file.close();
+        if (record >> name >> score) apply(name, score);
+    }
+    return true;
+}
+
+// Appends one result to the log and flushes it as a single write. The record then
+// survives a crash of the game, but sits in the OS cache for a few seconds: a power loss
+// can drop the latest results (never a compacted snapshot, see compactFiles). Syncing
+// every result would cap the server at one result per disk flush.
+void Leaderboard::appendRecord(const string& playerName, int score) {
+    string record = playerName + " " + to_string(score) + "\n";
+    logFile.write(record.data(), record.size());
+    logFile.flush();
+    logRecords++;
+}
+
+// Compacts once the log is as long as the table, within bounds that keep both the
+// compaction rate and the startup replay cheap.
+bool Leaderboard::needsCompaction() const {
+    return logRecords >= min(max(COMPACT_MIN_RECORDS, size()), COMPACT_MAX_RECORDS);
+}
+
+// Moves the current log aside and folds it into a new snapshot on a background thread.
+// The thread only writes the new file; finishCompaction() swaps it in.
+void Leaderboard::startCompaction() {
+    finishCompaction();
+    if (compacting) return; // The previous compaction is still running.
+
+    string logPath = filename + ".log";
+    string pendingPath = filename + ".compacting";
+    error_code error;
+    if (!filesystem::exists(pendingPath, error)) {
+        logFile.close();
+        filesystem::rename(logPath, pendingPath, error);
+        logFile.open(logPath, ios::app);
+        if (error) return;
+        foldedSequence = sequence;
+    }
+    logRecords = 0;
+
+    compacted = false;
+    compacting = true;
+    compactor = thread([this, pendingPath] {
+        compacted = mergeFiles(filename, {pendingPath}, filename + ".tmp");
+        compacting = false;
+    });
+}
+
+// Once the compactor is done, replaces the snapshot with the one it wrote and drops the
+// live scores that it folded in. Runs on the owning thread: the old snapshot is unmapped
+// first, since Windows cannot replace a file that is mapped.
+void Leaderboard::finishCompaction() {
+    if (compacting) return;
+    if (compactor.joinable()) compactor.join();
+    if (!compacted) return; // None finished, or it failed and the next one retries the folded log.
+    compacted = false;
+
+    archive.close();
+    bool replaced = replaceFile(filename + ".tmp", filename);
+    archive.open(filename);
+    if (!replaced) return;
+    error_code error;
+    filesystem::remove(filename + ".compacting", error);
+
+    // Rebuild the live indexes against the new snapshot from the scores set since.
+    vector<pair<string, ScoreKey>> kept;
+    for (const auto& entry : byName) {
+        if (entry.second.key.sequence > foldedSequence) kept.push_back({entry.first, entry.second.key});
+    }
+    byScore.clear();
+    byName.clear();
+    shadowed.clear();
+    liveOnly = 0;
+    for (const auto& entry : kept) {
+        long long archived = archive.find(entry.first);
+        byName.emplace(entry.first, LiveEntry{entry.second, archived});
+        if (archived < 0) liveOnly++;
+        else shadowed.insert(static_cast<size_t>(archived));
+        byScore.insert({entry.second, entry.first});
     }
 }
 
-// Saves the current leaderboard state back to the file.
-void Leaderboard::save() {
-    ofstream file(filename, ios::trunc); // Overwrite the file.
-    if (file.is_open()) {
-        for (const auto& entry : scores) {
-            file << entry.first << " " << entry.second << "\n"; // Write each score.
+// Merges a snapshot (binary, or text from older versions) with logs into a new binary
+// snapshot at `outputPath`, synced to disk. Records hold absolute scores, so replaying a
+// log twice after a crash is harmless.
+bool Leaderboard::mergeFiles(const string& snapshotPath, const vector<string>& logPaths, const string& outputPath) {
+    // Latest score per updated player, with the sequence number it was set at to keep tie order.
+    unordered_map<string, pair<int, size_t>> updated;
+    size_t sequence = 0;
+    auto apply = [&](const string& name, int score) { updated[name] = {score, sequence++}; };
+
+    LeaderboardFile base;
+    if (!base.open(snapshotPath)) readRecords(snapshotPath, apply);
+    for (const string& logPath : logPaths) readRecords(logPath, apply);
+
+    vector<pair<pair<int, size_t>, const string*>> ordered;
+    ordered.reserve(updated.size());
+    for (const auto& entry : updated) ordered.push_back({entry.second, &entry.first});
+    sort(ordered.begin(), ordered.end(), [](const auto& a, const auto& b) {
+        if (a.first.first != b.first.first) return a.first.first > b.first.first;
+        return a.first.second < b.first.second;
+    });
+
+    // Merge the snapshot, minus updated players, with the updates; the snapshot wins ties.
+    vector<pair<string_view, int>> merged;
+    merged.reserve(base.size() + ordered.size());
+    size_t position = 0;
+    auto copyBaseWhile = [&](auto keepGoing) {
+        for (; position < base.size() && keepGoing(base.score(position)); position++) {
+            string_view name = base.name(position);
+            if (updated.find(string(name)) == updated.end()) merged.emplace_back(name, base.score(position));
         }
-        file.close();
+    };
+    for (const auto& entry : ordered) {
+        int score = entry.first.first;
+        copyBaseWhile([score](int baseScore) { return baseScore >= score; });
+        merged.emplace_back(*entry.second, score);
+    }
+    copyBaseWhile([](int) { return true; });
+
+    return LeaderboardFile::write(outputPath, merged);
+}
+
+// Renames a finished file over another and syncs the directory. The new file is on disk
+// before the rename, and the rename before the caller deletes the folded log, so a power
+// loss leaves either the old snapshot with its log or the complete new one.
+bool Leaderboard::replaceFile(const string& fromPath, const string& toPath) {
+    error_code error;
+    filesystem::rename(fromPath, toPath, error);
+    if (error) return false;
+    string directory = filesystem::path(toPath).parent_path().string();
+    return LeaderboardFile::syncToDisk(directory.empty() ? "." : directory);
+}
+
+// Merges a snapshot with logs into a new binary snapshot, written to a temporary file
+// and renamed over `outputPath`.
+bool Leaderboard::compactFiles(const string& snapshotPath, const vector<string>& logPaths, const string& outputPath) {
+    string tempPath = outputPath + ".tmp";
+    return mergeFiles(snapshotPath, logPaths, tempPath) && replaceFile(tempPath, outputPath);
+}
+
+// Converts a text leaderboard, plus any log next to it, to the binary format.
+bool Leaderboard::convert(const string& textPath, const string& binaryPath) {
+    return compactFiles(textPath, {textPath + ".compacting", textPath + ".log"}, binaryPath);
+}
+
+// Moves a player to a new position in the score index in O(log n).
+void Leaderboard::setScore(const string& playerName, int score) {
+    ScoreKey key{score, ++sequence};
+    auto found = byName.find(playerName);
+    if (found != byName.end()) {
+        // Remove the old entry; the name map keeps the key of the reinserted one.
+        byScore.erase(found->second.key);
+        found->second.key = key;
+    } else {
+        long long archived = archive.find(playerName);
+        byName.emplace(playerName, LiveEntry{key, archived});
+        if (archived < 0) liveOnly++;
+        else shadowed.insert(static_cast<size_t>(archived));
     }
+    byScore.insert({key, playerName});
 }
 
-// Adds or updates a player's score, ensuring the leaderboard is sorted.
+// Adds or updates a player's score, keeping the index sorted highest first.
 void Leaderboard::addResult(const string& playerName, int score) {
-    // Check if the player already exists in the leaderboard.
-    auto it = find_if(scores.begin(), scores.end(), [&](const auto& entry) {
-        return entry.first == playerName;
-    });
+    setScore(playerName, score);
+    appendRecord(playerName, score); // Persist just this result.
+    finishCompaction();
+    if (needsCompaction()) {
+        startCompaction();
+    }
+}
 
-    if (it != scores.end()) {
-        // Update the player's score if found.
-        it->second = score;
+// Counts snapshot entries before `position` that a live score overrides.
+size_t Leaderboard::shadowedBefore(size_t position) const {
+    return shadowed.order_of_key(position);
+}
+
+// Returns the 1-based rank of a player, or 0 if the player has no score. Costs a binary
+// search in the snapshot plus two O(log n) order-statistics queries.
+int Leaderboard::rankOf(const string& playerName) const {
+    size_t ahead;
+    auto live = byName.find(playerName);
+    if (live != byName.end()) {
+        // Snapshot entries win ties against live ones, as in display().
+        size_t archivedAhead = archive.countAtLeast(live->second.key.score);
+        ahead = archivedAhead - shadowedBefore(archivedAhead) + byScore.order_of_key(live->second.key);
     } else {
-        // Add a new entry if the player is not found.
-        scores.emplace_back(playerName, score);
+        long long position = archive.find(playerName);
+        if (position < 0) return 0;
+        // Sequence 0 sorts before every live entry with the same score.
+        ahead = position - shadowedBefore(position) + byScore.order_of_key(ScoreKey{archive.score(position), 0});
     }
+    return static_cast<int>(ahead) + 1;
+}
 
-    // Sort the scores in descending order of scores (highest first).
-    sort(scores.begin(), scores.end(), [](const auto& a, const auto& b) {
-        return b.second > a.second;
-    });
-    save(); // Save the updated leaderboard.
+// Returns the number of players on the leaderboard.
+size_t Leaderboard::size() const {
+    return archive.size() + liveOnly;
 }
 
-// Displays the leaderboard in a formatted way.
-void Leaderboard::display() const {
-    cout << "\n--- Leaderboard ---\n";
-    for (const auto& entry : scores) {
-        cout << entry.first << ": " << entry.second << "\n"; // Print each player's score.
+// Displays the top K players, plus the given player's own rank if it falls below them.
+// Snapshot rows are read straight from the mapping.
+void Leaderboard::display(size_t topK, const string& playerName, ostream& out) const {
+    out << "\n--- Leaderboard ---\n";
+    size_t rank = 0;
+    size_t position = 0;
+    auto live = byScore.begin();
+    while (rank < topK) {
+        while (position < archive.size() && byName.count(string(archive.name(position)))) position++;
+        bool archived = position < archive.size();
+        if (!archived && live == byScore.end()) break;
+
+        if (archived && (live == byScore.end() || archive.score(position) >= live->first.score)) {
+            out << ++rank << ". " << archive.name(position) << ": " << archive.score(position) << "\n";
+            position++;
+        } else {
+            out << ++rank << ". " << live->second << ": " << live->first.score << "\n"; // Print each player's score.
+            ++live;
+        }
     }
-    cout << "-------------------\n";
-}
\ No newline at end of file
+
+    int playerRank = playerName.empty() ? 0 : rankOf(playerName);
+    if (playerRank > static_cast<int>(topK)) {
+        auto found = byName.find(playerName);
+        int playerScore = found != byName.end() ? found->second.key.score
+                                                : archive.score(archive.find(playerName));
+        out << "...\n" << playerRank << ". " << playerName << ": " << playerScore << "\n";
+    }
+    if (size() > rank) {
+        out << "(" << size() << " players)\n";
+    }
+    out << "-------------------\n";
+}
@@ -1,24 +1,91 @@
 #ifndef LEADERBOARD_H
 #define LEADERBOARD_H
 
+#include <atomic>
+#include <fstream>
+#include <functional>
+#include <iostream>
 #include <string>
+#include <thread>
+#include <unordered_map>
 #include <vector>
-#include <utility>
+#include <ext/pb_ds/assoc_container.hpp>
+#include <ext/pb_ds/tree_policy.hpp>
+#include "LeaderboardFile.h"
 
 using namespace std;
 
 class Leaderboard {
 private:
+    // A live score and when it was set, so equal scores keep the order they were reached in.
+    struct ScoreKey {
+        int score;
+        unsigned long long sequence;
+    };
+
+    struct HigherFirst {
+        bool operator()(const ScoreKey& a, const ScoreKey& b) const {
+            return a.score != b.score ? a.score > b.score : a.sequence < b.sequence;
+        }
+    };
+
+    // Order-statistics trees: besides ordered iteration, order_of_key() counts the keys
+    // ahead of a given one in O(log n), which is what a rank query needs.
+    using ScoreIndex = __gnu_pbds::tree<ScoreKey, string, HigherFirst, __gnu_pbds::rb_tree_tag,
+                                        __gnu_pbds::tree_order_statistics_node_update>;
+    using PositionSet = __gnu_pbds::tree<size_t, __gnu_pbds::null_type, less<size_t>, __gnu_pbds::rb_tree_tag,
+                                         __gnu_pbds::tree_order_statistics_node_update>;
+
+    // A player whose score changed since the snapshot was written, and where the
+    // snapshot still ranks them (-1 if it does not know them).
+    struct LiveEntry {
+        ScoreKey key;
+        long long archived;
+    };
+
+    // Persistence: `filename` holds a memory-mapped LeaderboardFile snapshot, `filename.log`
+    // every result since then, and `filename.compacting` a log that is being folded into
+    // the snapshot, written to `filename.tmp`. Only the logs are parsed at startup.
+    static constexpr size_t COMPACT_MIN_RECORDS = 1024;
+    static constexpr size_t COMPACT_MAX_RECORDS = 65536;
+
     string filename;
-    vector<pair<string, int>> scores;
+    LeaderboardFile archive;
+    ScoreIndex byScore;
+    unordered_map<string, LiveEntry> byName;
+    PositionSet shadowed;   // Snapshot positions of the live players it still ranks.
+    unsigned long long sequence;
+    size_t liveOnly;    // Live players the snapshot does not contain.
+    unsigned long long foldedSequence;  // Live scores up to this one are in `filename.compacting`.
+
+    ofstream logFile;
+    size_t logRecords;
+    thread compactor;
+    atomic<bool> compacting;
+    bool compacted;     // The compactor wrote the new snapshot; set before `compacting` clears.
 
     void load(); 
-    void save(); 
+    static bool readRecords(const string& path, const function<void(const string&, int)>& apply);
+    void appendRecord(const string& playerName, int score);
+    bool needsCompaction() const;
+    void startCompaction();
+    void finishCompaction();
+    static bool mergeFiles(const string& snapshotPath, const vector<string>& logPaths, const string& outputPath);
+    static bool replaceFile(const string& fromPath, const string& toPath);
+    static bool compactFiles(const string& snapshotPath, const vector<string>& logPaths, const string& outputPath);
+    void setScore(const string& playerName, int score);
+    size_t shadowedBefore(size_t position) const;
 
 public:
     Leaderboard(const string& file);
+    ~Leaderboard();
+    Leaderboard(const Leaderboard&) = delete;
+    Leaderboard& operator=(const Leaderboard&) = delete;
     void addResult(const string& playerName, int score);
-    void display() const;
+    int rankOf(const string& playerName) const;
+    size_t size() const;
+    void display(size_t topK = 10, const string& playerName = "", ostream& out = cout) const;
+    static bool convert(const string& textPath, const string& binaryPath);
 };
 
 #endif
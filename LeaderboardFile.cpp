@@ -0,0 +1,225 @@
+#include "LeaderboardFile.h"
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+
+#ifdef _WIN32
+    #include <windows.h>
+#else
+    #include <fcntl.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <unistd.h>
+#endif
+
+using namespace std;
+
+static const char MAGIC[8] = {'S', 'D', 'K', 'L', 'B', 'R', 'D', '\0'};
+
+LeaderboardFile::LeaderboardFile()
+    : data(nullptr), length(0), header(nullptr), recordTable(nullptr), names(nullptr), nameIndex(nullptr)
+#ifdef _WIN32
+    , fileHandle(nullptr), mappingHandle(nullptr)
+#endif
+{}
+
+LeaderboardFile::~LeaderboardFile() {
+    close();
+}
+
+// Maps a binary leaderboard. Returns false if the file is missing or not in this format.
+bool LeaderboardFile::open(const string& path) {
+    close();
+#ifdef _WIN32
+    HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_DELETE, nullptr,
+                              OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE) return false;
+    LARGE_INTEGER fileSize;
+    if (!GetFileSizeEx(file, &fileSize) || fileSize.QuadPart < static_cast<LONGLONG>(sizeof(Header))) {
+        CloseHandle(file);
+        return false;
+    }
+    HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    void* view = mapping ? MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0) : nullptr;
+    if (!view) {
+        if (mapping) CloseHandle(mapping);
+        CloseHandle(file);
+        return false;
+    }
+    fileHandle = file;
+    mappingHandle = mapping;
+    data = static_cast<const char*>(view);
+    length = static_cast<size_t>(fileSize.QuadPart);
+#else
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) return false;
+    struct stat info;
+    if (fstat(fd, &info) != 0 || info.st_size < static_cast<off_t>(sizeof(Header))) {
+        ::close(fd);
+        return false;
+    }
+    void* view = mmap(nullptr, static_cast<size_t>(info.st_size), PROT_READ, MAP_SHARED, fd, 0);
+    ::close(fd); // The mapping keeps the file alive.
+    if (view == MAP_FAILED) return false;
+    data = static_cast<const char*>(view);
+    length = static_cast<size_t>(info.st_size);
+#endif
+
+    if (!validate()) {
+        close();
+        return false;
+    }
+    return true;
+}
+
+// Checks the header and that every section lies inside the mapping.
+bool LeaderboardFile::validate() {
+    header = reinterpret_cast<const Header*>(data);
+    if (memcmp(header->magic, MAGIC, sizeof(MAGIC)) != 0) return false;
+    if (header->version != VERSION || header->recordSize != sizeof(Record)) return false;
+
+    uint64_t recordsEnd = sizeof(Header) + header->records * sizeof(Record);
+    uint64_t indexEnd = header->indexOffset + header->records * sizeof(uint32_t);
+    if (header->records > length / sizeof(Record)) return false;
+    if (header->namesSize > length || header->namesOffset < recordsEnd || header->namesOffset + header->namesSize > length) return false;
+    if (header->indexOffset % alignof(uint32_t) != 0 || header->indexOffset < header->namesOffset + header->namesSize
+        || indexEnd > length) return false;
+
+    recordTable = reinterpret_cast<const Record*>(data + sizeof(Header));
+    names = data + header->namesOffset;
+    nameIndex = reinterpret_cast<const uint32_t*>(data + header->indexOffset);
+    return true;
+}
+
+// Unmaps the file, if one is open.
+void LeaderboardFile::close() {
+    if (data) {
+#ifdef _WIN32
+        UnmapViewOfFile(data);
+        CloseHandle(static_cast<HANDLE>(mappingHandle));
+        CloseHandle(static_cast<HANDLE>(fileHandle));
+        fileHandle = mappingHandle = nullptr;
+#else
+        munmap(const_cast<char*>(data), length);
+#endif
+    }
+    data = nullptr;
+    length = 0;
+    header = nullptr;
+    recordTable = nullptr;
+    names = nullptr;
+    nameIndex = nullptr;
+}
+
+bool LeaderboardFile::isOpen() const {
+    return data != nullptr;
+}
+
+// Returns the number of players in the file.
+size_t LeaderboardFile::size() const {
+    return header ? static_cast<size_t>(header->records) : 0;
+}
+
+// Returns the score at a 0-based position in ranking order.
+int LeaderboardFile::score(size_t position) const {
+    return recordTable[position].score;
+}
+
+// Returns the name at a 0-based position in ranking order, without copying it.
+string_view LeaderboardFile::name(size_t position) const {
+    const Record& record = recordTable[position];
+    if (static_cast<uint64_t>(record.nameOffset) + record.nameLength > header->namesSize) return {};
+    return string_view(names + record.nameOffset, record.nameLength);
+}
+
+// Returns a player's 0-based ranking position, or -1 if the player is not in the file.
+long long LeaderboardFile::find(string_view playerName) const {
+    size_t low = 0, high = size();
+    while (low < high) {
+        size_t middle = low + (high - low) / 2;
+        uint32_t position = nameIndex[middle];
+        if (position >= size()) return -1;
+        string_view candidate = name(position);
+        if (candidate == playerName) return position;
+        if (candidate < playerName) low = middle + 1;
+        else high = middle;
+    }
+    return -1;
+}
+
+// Returns how many players have at least the given score.
+size_t LeaderboardFile::countAtLeast(int score) const {
+    const Record* end = recordTable + size();
+    return static_cast<size_t>(partition_point(recordTable, end, [score](const Record& record) {
+        return record.score >= score;
+    }) - recordTable);
+}
+
+// Tells whether a file starts with the binary leaderboard header.
+bool LeaderboardFile::isBinary(const string& path) {
+    ifstream file(path, ios::binary);
+    char magic[sizeof(MAGIC)];
+    return file.read(magic, sizeof(magic)) && memcmp(magic, MAGIC, sizeof(MAGIC)) == 0;
+}
+
+// Writes entries, which must already be in ranking order, as a binary leaderboard.
+bool LeaderboardFile::write(const string& path, const vector<pair<string_view, int>>& entries) {
+    Header header = {};
+    memcpy(header.magic, MAGIC, sizeof(MAGIC));
+    header.version = VERSION;
+    header.recordSize = sizeof(Record);
+    header.records = entries.size();
+
+    vector<Record> records(entries.size());
+    uint64_t namesSize = 0;
+    for (size_t i = 0; i < entries.size(); i++) {
+        records[i] = {entries[i].second, static_cast<uint32_t>(namesSize),
+                      static_cast<uint32_t>(entries[i].first.size())};
+        namesSize += entries[i].first.size();
+    }
+    if (namesSize > UINT32_MAX || entries.size() > UINT32_MAX) return false;
+
+    vector<uint32_t> index(entries.size());
+    for (size_t i = 0; i < index.size(); i++) index[i] = static_cast<uint32_t>(i);
+    sort(index.begin(), index.end(), [&](uint32_t a, uint32_t b) {
+        return entries[a].first < entries[b].first;
+    });
+
+    header.namesOffset = sizeof(Header) + records.size() * sizeof(Record);
+    header.namesSize = namesSize;
+    uint64_t padding = (alignof(uint32_t) - (header.namesOffset + namesSize) % alignof(uint32_t)) % alignof(uint32_t);
+    header.indexOffset = header.namesOffset + namesSize + padding;
+
+    ofstream file(path, ios::binary | ios::trunc);
+    if (!file.is_open()) return false;
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    file.write(reinterpret_cast<const char*>(records.data()), records.size() * sizeof(Record));
+    for (const auto& entry : entries) file.write(entry.first.data(), entry.first.size());
+    const char zeros[alignof(uint32_t)] = {};
+    file.write(zeros, padding);
+    file.write(reinterpret_cast<const char*>(index.data()), index.size() * sizeof(uint32_t));
+    file.close();
+    return !file.fail() && syncToDisk(path);
+}
+
+// Forces a file's data, or a directory's entries, out of the OS cache onto the disk, so a
+// power loss cannot undo it. Windows commits renames itself and has no directory flush.
+bool LeaderboardFile::syncToDisk(const string& path) {
+#ifdef _WIN32
+    DWORD attributes = GetFileAttributesA(path.c_str());
+    if (attributes == INVALID_FILE_ATTRIBUTES) return false;
+    if (attributes & FILE_ATTRIBUTE_DIRECTORY) return true;
+    HANDLE file = CreateFileA(path.c_str(), GENERIC_WRITE, FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE,
+                              nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE) return false;
+    bool flushed = FlushFileBuffers(file) != 0;
+    CloseHandle(file);
+    return flushed;
+#else
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) return false;
+    bool flushed = fsync(fd) == 0;
+    ::close(fd);
+    return flushed;
+#endif
+}
@@ -0,0 +1,74 @@
+#ifndef LEADERBOARDFILE_H
+#define LEADERBOARDFILE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+using namespace std;
+
+// Read-only, memory-mapped binary leaderboard. Opening is O(1) whatever the size;
+// entries are read straight out of the mapping.
+//
+// Layout: Header, then `records` Records sorted best score first, then the name table
+// (each player's name stored once, unterminated), then a uint32 index of record
+// positions sorted by name for O(log n) lookups.
+class LeaderboardFile {
+public:
+    struct Header {
+        char magic[8];
+        uint32_t version;
+        uint32_t recordSize;
+        uint64_t records;
+        uint64_t namesOffset;
+        uint64_t namesSize;
+        uint64_t indexOffset;
+    };
+
+    struct Record {
+        int32_t score;
+        uint32_t nameOffset;    // Relative to the start of the name table.
+        uint32_t nameLength;
+    };
+
+    static constexpr uint32_t VERSION = 1;
+
+private:
+    const char* data;
+    size_t length;
+    const Header* header;
+    const Record* recordTable;
+    const char* names;
+    const uint32_t* nameIndex;
+#ifdef _WIN32
+    void* fileHandle;
+    void* mappingHandle;
+#endif
+
+    bool validate();
+
+public:
+    LeaderboardFile();
+    ~LeaderboardFile();
+    LeaderboardFile(const LeaderboardFile&) = delete;
+    LeaderboardFile& operator=(const LeaderboardFile&) = delete;
+
+    bool open(const string& path);
+    void close();
+    bool isOpen() const;
+
+    size_t size() const;
+    int score(size_t position) const;
+    string_view name(size_t position) const;
+    long long find(string_view playerName) const;
+    size_t countAtLeast(int score) const;
+
+    static bool isBinary(const string& path);
+    static bool write(const string& path, const vector<pair<string_view, int>>& entries);
+    static bool syncToDisk(const string& path);
+};
+
+#endif // LEADERBOARDFILE_H
@@ -0,0 +1,197 @@
+#include "LoadClient.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <thread>
+#include <vector>
+
+#ifdef __linux__
+    #include <arpa/inet.h>
+    #include <netinet/in.h>
+    #include <netinet/tcp.h>
+    #include <sys/socket.h>
+    #include <sys/un.h>
+    #include <unistd.h>
+#endif
+
+using namespace std;
+
+#ifdef __linux__
+
+namespace {
+
+// One scripted player: NEW, then HINT and MOVE until SOLVED, `games` times over.
+struct Bot {
+    int fd = -1;
+    string buffer;
+    string name;
+    int gamesLeft = 0;
+    string pending;     // The move to play after the last HINT reply.
+    bool done = false;
+};
+
+int connectTo(const string& endpoint) {
+    bool isPort = !endpoint.empty() && all_of(endpoint.begin(), endpoint.end(), ::isdigit);
+    if (isPort) {
+        int fd = socket(AF_INET, SOCK_STREAM, 0);
+        sockaddr_in address = {};
+        address.sin_family = AF_INET;
+        address.sin_port = htons(static_cast<uint16_t>(stoi(endpoint)));
+        address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        if (fd >= 0 && connect(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) == 0) {
+            int yes = 1;
+            setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &yes, sizeof(yes));
+            return fd;
+        }
+        if (fd >= 0) close(fd);
+        return -1;
+    }
+
+    sockaddr_un address = {};
+    if (endpoint.size() >= sizeof(address.sun_path)) return -1;
+    int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    address.sun_family = AF_UNIX;
+    memcpy(address.sun_path, endpoint.c_str(), endpoint.size() + 1);
+    if (fd >= 0 && connect(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) == 0) return fd;
+    if (fd >= 0) close(fd);
+    return -1;
+}
+
+bool sendLine(int fd, const string& line) {
+    string data = line + "\n";
+    size_t sent = 0;
+    while (sent < data.size()) {
+        ssize_t count = send(fd, data.data() + sent, data.size() - sent, MSG_NOSIGNAL);
+        if (count <= 0) return false;
+        sent += static_cast<size_t>(count);
+    }
+    return true;
+}
+
+bool readLine(Bot& bot, string& line) {
+    size_t end;
+    while ((end = bot.buffer.find('\n')) == string::npos) {
+        char chunk[4096];
+        ssize_t count = recv(bot.fd, chunk, sizeof(chunk), 0);
+        if (count <= 0) return false;
+        bot.buffer.append(chunk, static_cast<size_t>(count));
+    }
+    line = bot.buffer.substr(0, end);
+    bot.buffer.erase(0, end + 1);
+    return true;
+}
+
+// Picks the command that follows a reply.
+string nextCommand(Bot& bot, const string& reply, long long& games, long long& errors) {
+    istringstream in(reply);
+    string kind;
+    in >> kind;
+    if (kind == "HINT") {
+        int row, col, value;
+        in >> row >> col >> value;
+        return "MOVE " + to_string(row) + " " + to_string(col) + " " + to_string(value);
+    }
+    if (kind == "SOLVED") {
+        games++;
+        if (--bot.gamesLeft <= 0) return "QUIT";
+        return "NEW " + bot.name + " " + to_string(1 + bot.gamesLeft % 4);
+    }
+    if (kind == "ERR") errors++;
+    return "HINT";
+}
+
+} // namespace
+
+// Runs the bots in lockstep: each thread sends one command on each of its sessions,
+// then reads every reply, so all sessions stay concurrently open on the server.
+LoadClient::Summary LoadClient::run(const string& endpoint, int sessions, int gamesPerSession, unsigned threads) {
+    Summary summary;
+    if (threads == 0) threads = max(1u, thread::hardware_concurrency());
+    threads = min<unsigned>(threads, max(1, sessions));
+    atomic<long long> games{0}, commands{0}, errors{0}, connected{0};
+
+    auto begin = chrono::steady_clock::now();
+    vector<thread> workers;
+    for (unsigned t = 0; t < threads; t++) {
+        workers.emplace_back([&, t] {
+            vector<Bot> bots;
+            for (int i = static_cast<int>(t); i < sessions; i += static_cast<int>(threads)) {
+                Bot bot;
+                bot.fd = connectTo(endpoint);
+                if (bot.fd < 0) {
+                    errors++;
+                    continue;
+                }
+                bot.name = "bot" + to_string(i);
+                bot.gamesLeft = max(1, gamesPerSession);
+                bot.pending = "NEW " + bot.name + " " + to_string(1 + i % 4);
+                bots.push_back(move(bot));
+            }
+            connected += static_cast<long long>(bots.size());
+
+            long long localGames = 0, localCommands = 0, localErrors = 0;
+            size_t active = bots.size();
+            while (active > 0) {
+                for (Bot& bot : bots) {
+                    if (bot.done) continue;
+                    if (!sendLine(bot.fd, bot.pending)) {
+                        bot.done = true;
+                        localErrors++;
+                        active--;
+                    }
+                    localCommands++;
+                }
+                for (Bot& bot : bots) {
+                    if (bot.done) continue;
+                    string reply;
+                    if (!readLine(bot, reply)) {
+                        bot.done = true;
+                        localErrors++;
+                        active--;
+                        continue;
+                    }
+                    if (bot.pending == "QUIT") {
+                        bot.done = true;
+                        active--;
+                        continue;
+                    }
+                    bot.pending = nextCommand(bot, reply, localGames, localErrors);
+                }
+            }
+            for (Bot& bot : bots) close(bot.fd);
+            games += localGames;
+            commands += localCommands;
+            errors += localErrors;
+        });
+    }
+    for (thread& worker : workers) worker.join();
+
+    summary.sessions = static_cast<int>(connected);
+    summary.games = games;
+    summary.commands = commands;
+    summary.errors = errors;
+    summary.seconds = chrono::duration<double>(chrono::steady_clock::now() - begin).count();
+    return summary;
+}
+
+#else
+
+LoadClient::Summary LoadClient::run(const string&, int, int, unsigned) {
+    return Summary();
+}
+
+#endif
+
+// Prints games and commands per second.
+void LoadClient::printSummary(const Summary& summary, ostream& out) {
+    double seconds = max(summary.seconds, 1e-9);
+    out << "Sessions: " << summary.sessions << ", games: " << summary.games
+        << ", commands: " << summary.commands << ", errors: " << summary.errors << "\n"
+        << fixed << setprecision(3) << "Time: " << summary.seconds << " s, "
+        << setprecision(0) << summary.commands / seconds << " commands/s, "
+        << summary.games / seconds << " games/s\n";
+}
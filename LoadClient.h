@@ -0,0 +1,25 @@
+#ifndef LOAD_CLIENT_H
+#define LOAD_CLIENT_H
+
+#include <ostream>
+#include <string>
+using namespace std;
+
+// Scripted client for GameServer: opens many sessions and plays every game to the
+// end with HINT + MOVE, then reports throughput. Linux only, like the server.
+class LoadClient {
+public:
+    struct Summary {
+        int sessions = 0;
+        long long games = 0;
+        long long commands = 0;
+        long long errors = 0;
+        double seconds = 0;
+    };
+
+    // `endpoint` is a TCP port on 127.0.0.1, or a Unix socket path.
+    static Summary run(const string& endpoint, int sessions, int gamesPerSession, unsigned threads = 0);
+    static void printSummary(const Summary& summary, ostream& out);
+};
+
+#endif
@@ -0,0 +1,249 @@
+#include "MoveJournal.h"
+#include <chrono>
+#include <cstring>
+#include <filesystem>
+#include <stdexcept>
+#include <unordered_map>
+#include <vector>
+using namespace std;
+
+static const char MAGIC[8] = {'S', 'D', 'K', 'J', 'R', 'N', 'L', '\0'};
+
+static int64_t now() {
+    return chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+MoveJournal::MoveJournal()
+    : file(nullptr), fileSize(0), buffer(new Record[BUFFER_RECORDS]), buffered(0), nextSession(0), dropped(0) {}
+
+MoveJournal::~MoveJournal() {
+    close();
+}
+
+// Opens `path` for appending, writing the header if the file is new. A crash can cut the
+// last batch mid-record; that partial record is cut off so new records stay aligned.
+// Returns false if the file cannot be opened or holds something other than a journal.
+bool MoveJournal::open(const string& path) {
+    close();
+    file = fopen(path.c_str(), "a+b");
+    if (!file) return false;
+    setvbuf(file, nullptr, _IONBF, 0); // The record buffer is the only buffering.
+
+    fseek(file, 0, SEEK_END);
+    long size = ftell(file);
+    if (size == 0) {
+        Header header = {};
+        memcpy(header.magic, MAGIC, sizeof(MAGIC));
+        header.version = VERSION;
+        header.recordSize = sizeof(Record);
+        if (fwrite(&header, sizeof(header), 1, file) != 1) {
+            fclose(file);
+            file = nullptr;
+            return false;
+        }
+        size = sizeof(header);
+    } else {
+        Header header;
+        rewind(file);
+        if (fread(&header, sizeof(header), 1, file) != 1 || memcmp(header.magic, MAGIC, sizeof(MAGIC)) != 0 ||
+            header.version != VERSION || header.recordSize != sizeof(Record)) {
+            fclose(file);
+            file = nullptr;
+            return false;
+        }
+        long whole = static_cast<long>(sizeof(Header) + (size - sizeof(Header)) / sizeof(Record) * sizeof(Record));
+        if (whole != size) {
+            fclose(file);
+            file = nullptr;
+            error_code error;
+            filesystem::resize_file(path, static_cast<uintmax_t>(whole), error);
+            if (error || !(file = fopen(path.c_str(), "a+b"))) return false;
+            setvbuf(file, nullptr, _IONBF, 0);
+            size = whole;
+        }
+    }
+    filePath = path;
+    fileSize = size;
+    // Numbering sessions by their position in the file keeps them unique across runs.
+    nextSession = static_cast<uint32_t>((size - sizeof(Header)) / sizeof(Record));
+    return true;
+}
+
+// Writes out what is buffered and closes the file; what the disk still refuses is dropped.
+void MoveJournal::close() {
+    if (!file) return;
+    if (!flush()) dropped += static_cast<long long>(buffered);
+    buffered = 0;
+    fclose(file);
+    file = nullptr;
+}
+
+bool MoveJournal::isOpen() const {
+    return file != nullptr;
+}
+
+// Writes the buffered records in one call. After a short write (a full disk) a partial
+// record is cut off and the records not written stay buffered for the next flush.
+// Returns false if some are still waiting.
+bool MoveJournal::flush() {
+    if (!file || buffered == 0) return true;
+    size_t written = fwrite(buffer.get(), sizeof(Record), buffered, file);
+    fileSize += static_cast<long long>(written * sizeof(Record));
+    if (written == buffered) {
+        buffered = 0;
+        return true;
+    }
+
+    clearerr(file);
+    error_code error;
+    filesystem::resize_file(filePath, static_cast<uintmax_t>(fileSize), error);
+    memmove(buffer.get(), buffer.get() + written, (buffered - written) * sizeof(Record));
+    buffered -= written;
+    return false;
+}
+
+// Records lost so far because the disk would not take them.
+long long MoveJournal::droppedRecords() const {
+    return dropped;
+}
+
+void MoveJournal::append(const Record& record) {
+    if (buffered == BUFFER_RECORDS && !flush() && buffered == BUFFER_RECORDS) {
+        dropped++;
+        return;
+    }
+    buffer[buffered++] = record;
+}
+
+// Starts a session from the board it begins with; returns the id to record its moves under.
+uint32_t MoveJournal::startSession(const GameSnapshot& snapshot) {
+    uint32_t session = nextSession;
+    nextSession += 1 + SNAPSHOT_RECORDS;
+    if (!file) return session;
+
+    append({now(), session, START, 0, 0, 0});
+    Record payload[SNAPSHOT_RECORDS] = {};
+    memcpy(payload, &snapshot, sizeof(snapshot));
+    for (const Record& record : payload) append(record);
+    return session;
+}
+
+// Notes one applied command of a session.
+void MoveJournal::record(uint32_t session, Kind kind, int row, int col, int value) {
+    if (!file) return;
+    append({now(), session, kind, static_cast<uint8_t>(row), static_cast<uint8_t>(col), static_cast<uint8_t>(value)});
+}
+
+// Feeds a journal back through SudokuBoard and sums up what the players did. Returns false
+// if the file is missing or not a journal.
+bool MoveJournal::replay(const string& path, Analytics& analytics) {
+    FILE* in = fopen(path.c_str(), "rb");
+    if (!in) return false;
+    Header header;
+    if (fread(&header, sizeof(header), 1, in) != 1 || memcmp(header.magic, MAGIC, sizeof(MAGIC)) != 0 ||
+        header.version != VERSION || header.recordSize != sizeof(Record)) {
+        fclose(in);
+        return false;
+    }
+
+    struct Replayed {
+        SudokuBoard board;
+        int64_t startNanos;
+        int64_t lastNanos;
+    };
+    unordered_map<uint32_t, Replayed> sessions;
+    Replayed* current = nullptr;
+    uint32_t currentId = 0;
+
+    auto started = chrono::steady_clock::now();
+    const size_t CHUNK = 1 << 16;
+    vector<Record> chunk(CHUNK);
+    size_t have = 0, pos = 0;
+    bool atEnd = false;
+    while (true) {
+        // Keep a whole START record and its snapshot in the chunk.
+        if (!atEnd && have - pos < 1 + SNAPSHOT_RECORDS) {
+            memmove(chunk.data(), chunk.data() + pos, (have - pos) * sizeof(Record));
+            have -= pos;
+            pos = 0;
+            size_t got = fread(chunk.data() + have, sizeof(Record), CHUNK - have, in);
+            have += got;
+            atEnd = got == 0;
+            continue;
+        }
+        if (pos == have) break;
+
+        const Record& record = chunk[pos++];
+        analytics.records++;
+        if (record.kind == START) {
+            if (have - pos < static_cast<size_t>(SNAPSHOT_RECORDS)) {
+                analytics.rejected++;
+                break;
+            }
+            GameSnapshot snapshot;
+            memcpy(&snapshot, chunk.data() + pos, sizeof(snapshot));
+            pos += SNAPSHOT_RECORDS;
+            Replayed& replayed = sessions[record.session];
+            try {
+                snapshot.restore(replayed.board);
+            } catch (const invalid_argument&) {
+                sessions.erase(record.session);
+                current = nullptr;
+                analytics.rejected++;
+                continue;
+            }
+            replayed.startNanos = record.nanos - static_cast<int64_t>(snapshot.seconds) * 1000000000;
+            replayed.lastNanos = record.nanos;
+            current = &replayed;
+            currentId = record.session;
+            analytics.sessions++;
+            continue;
+        }
+
+        if (!current || currentId != record.session) {
+            auto found = sessions.find(record.session);
+            if (found == sessions.end()) {
+                analytics.rejected++;
+                continue;
+            }
+            current = &found->second;
+            currentId = record.session;
+        }
+        SudokuBoard& board = current->board;
+        double waited = (record.nanos - current->lastNanos) / 1e9;
+        current->lastNanos = record.nanos;
+        try {
+            switch (record.kind) {
+                case MOVE: {
+                    board.makeMove(record.row, record.col, record.value);
+                    analytics.moves++;
+                    if (record.value != board.getSolutionValue(record.row, record.col)) {
+                        analytics.wrongMoves++;
+                    } else {
+                        analytics.correctMoves++;
+                        analytics.cellSeconds += waited;
+                    }
+                    if (board.isSolved()) {
+                        analytics.solved++;
+                        analytics.solveSeconds += (record.nanos - current->startNanos) / 1e9;
+                    }
+                    break;
+                }
+                case ERASE:
+                    board.deleteMove(record.row, record.col);
+                    analytics.erases++;
+                    break;
+                case HINT:
+                    analytics.hints++;
+                    break;
+                default:
+                    analytics.rejected++;
+            }
+        } catch (const invalid_argument&) {
+            analytics.rejected++;
+        }
+    }
+    fclose(in);
+    analytics.replaySeconds = chrono::duration<double>(chrono::steady_clock::now() - started).count();
+    return true;
+}
@@ -0,0 +1,90 @@
+#ifndef MOVE_JOURNAL_H
+#define MOVE_JOURNAL_H
+
+#include "GameSnapshot.h"
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <string>
+using namespace std;
+
+// Opt-in, append-only binary log of what players do. Records are 16 bytes and collect in
+// an in-memory buffer that is written out a batch at a time, so recording a move costs a
+// store, not a syscall. Not thread-safe: one journal per thread (the server has one).
+//
+// Layout: Header, then Records. A START record is followed by the session's GameSnapshot,
+// padded to whole records, so a replay can rebuild every board from the file alone.
+class MoveJournal {
+public:
+    enum Kind : uint8_t { START, MOVE, ERASE, HINT };
+
+    struct Header {
+        char magic[8];
+        uint32_t version;
+        uint32_t recordSize;
+    };
+
+    struct Record {
+        int64_t nanos;          // steady_clock time, so only differences mean anything.
+        uint32_t session;
+        uint8_t kind;
+        uint8_t row;            // 0-based.
+        uint8_t col;
+        uint8_t value;
+    };
+
+    // What a replay found, summed over all sessions in the journal.
+    struct Analytics {
+        long long records = 0;
+        long long sessions = 0;
+        long long solved = 0;
+        long long moves = 0;
+        long long wrongMoves = 0;       // Moves whose number differs from the solution.
+        long long erases = 0;
+        long long hints = 0;
+        long long rejected = 0;         // Records the board refused; a damaged journal.
+        double solveSeconds = 0;        // Summed over solved sessions.
+        double cellSeconds = 0;         // Time spent before each correct placement, summed.
+        long long correctMoves = 0;
+        double replaySeconds = 0;
+
+        double errorRate() const { return moves ? double(wrongMoves) / moves : 0; }
+        double secondsPerCell() const { return correctMoves ? cellSeconds / correctMoves : 0; }
+    };
+
+    static constexpr uint32_t VERSION = 1;
+    static constexpr int SNAPSHOT_RECORDS = (sizeof(GameSnapshot) + sizeof(Record) - 1) / sizeof(Record);
+    static const size_t BUFFER_RECORDS = 4096;
+
+private:
+    FILE* file;
+    string filePath;
+    long long fileSize;         // Bytes of whole records on disk.
+    unique_ptr<Record[]> buffer;
+    size_t buffered;
+    uint32_t nextSession;
+    long long dropped;          // Records lost because the buffer was full and could not be written.
+
+    void append(const Record& record);
+
+public:
+    MoveJournal();
+    ~MoveJournal();
+    MoveJournal(const MoveJournal&) = delete;
+    MoveJournal& operator=(const MoveJournal&) = delete;
+
+    bool open(const string& path);
+    void close();
+    bool isOpen() const;
+    bool flush();
+    long long droppedRecords() const;
+
+    uint32_t startSession(const GameSnapshot& snapshot);
+    void record(uint32_t session, Kind kind, int row, int col, int value);
+
+    static bool replay(const string& path, Analytics& analytics);
+};
+
+static_assert(sizeof(MoveJournal::Record) == 16, "journal records are 16 bytes on disk");
+
+#endif // MOVE_JOURNAL_H
@@ -0,0 +1,258 @@
+#include "ParallelSolver.h"
+#include "BitUtils.h"
+#include <algorithm>
+using namespace std;
+
+// Constructor: Starts threadCount - 1 helpers (0 means one per hardware thread);
+// the thread calling solve or count is the last worker.
+template <int BOX>
+BasicParallelSolver<BOX>::BasicParallelSolver(unsigned threadCount)
+    : generation(0), busyHelpers(0), shuttingDown(false), mode(Mode::SOLVE), limit(0), visitor(nullptr),
+    stop(false), pending(0), queued(0), idle(0), parked(0), found(0), nodeCount(0) {
+    if (threadCount == 0) threadCount = max(1u, thread::hardware_concurrency());
+    for (unsigned i = 0; i < threadCount; i++) workers.emplace_back(new Worker());
+    for (unsigned i = 1; i < threadCount; i++) threads.emplace_back(&BasicParallelSolver::helperLoop, this, i);
+}
+
+template <int BOX>
+BasicParallelSolver<BOX>::~BasicParallelSolver() {
+    {
+        lock_guard<mutex> guard(jobLock);
+        shuttingDown = true;
+    }
+    jobReady.notify_all();
+    for (thread& helper : threads) helper.join();
+}
+
+// Name used to select this engine at runtime.
+template <int BOX>
+string BasicParallelSolver<BOX>::name() const {
+    return "parallel";
+}
+
+// A helper sleeps until a search starts, joins it, and reports back when it is over.
+template <int BOX>
+void BasicParallelSolver<BOX>::helperLoop(unsigned index) {
+    unsigned long long seen = 0;
+    while (true) {
+        {
+            unique_lock<mutex> guard(jobLock);
+            jobReady.wait(guard, [&] { return shuttingDown || generation != seen; });
+            if (shuttingDown) return;
+            seen = generation;
+        }
+        work(index);
+        {
+            lock_guard<mutex> guard(jobLock);
+            if (--busyHelpers == 0) jobDone.notify_one();
+        }
+    }
+}
+
+// Takes the newest task of this worker, or else steals the oldest one of another worker.
+// The oldest tasks were split off nearest the root, so they tend to be the biggest.
+template <int BOX>
+bool BasicParallelSolver<BOX>::takeTask(unsigned index, State& task) {
+    {
+        Worker& own = *workers[index];
+        lock_guard<mutex> guard(own.lock);
+        if (!own.tasks.empty()) {
+            task = own.tasks.back();
+            own.tasks.pop_back();
+            queued--;
+            return true;
+        }
+    }
+    for (size_t step = 1; step < workers.size(); step++) {
+        Worker& victim = *workers[(index + step) % workers.size()];
+        lock_guard<mutex> guard(victim.lock);
+        if (!victim.tasks.empty()) {
+            task = victim.tasks.front();
+            victim.tasks.pop_front();
+            queued--;
+            return true;
+        }
+    }
+    return false;
+}
+
+// Wakes the parked workers. Taking the lock first means a worker that has just found
+// nothing to do either sees the change or is already waiting when the notification comes.
+template <int BOX>
+void BasicParallelSolver<BOX>::wakeIdle() {
+    if (parked.load() == 0) return;
+    { lock_guard<mutex> guard(idleLock); }
+    taskReady.notify_all();
+}
+
+// Runs tasks until the tree is exhausted or the search is stopped. A worker that finds
+// nothing to steal retries a few times, then sleeps instead of spinning on a core the
+// busy workers could use.
+template <int BOX>
+void BasicParallelSolver<BOX>::work(unsigned index) {
+    static const int SPINS = 64;
+    bool waiting = false;
+    int misses = 0;
+    State task;
+    while (!stop.load(memory_order_relaxed) && pending.load() > 0) {
+        if (takeTask(index, task)) {
+            if (waiting) {
+                idle--;
+                waiting = false;
+            }
+            misses = 0;
+            explore(*workers[index], task);
+            if (--pending == 0) wakeIdle();
+        } else {
+            if (!waiting) {
+                idle++;
+                waiting = true;
+            }
+            if (++misses < SPINS) {
+                this_thread::yield();
+                continue;
+            }
+            unique_lock<mutex> guard(idleLock);
+            parked++;
+            taskReady.wait(guard, [&] { return stop.load() || pending.load() == 0 || queued.load() > 0; });
+            parked--;
+            misses = 0;
+        }
+    }
+    if (waiting) idle--;
+}
+
+// The bitmask solver's search, except that while some worker is idle the untried branches
+// of a node become tasks for others instead of waiting on this stack.
+template <int BOX>
+void BasicParallelSolver<BOX>::explore(Worker& worker, State& state) {
+    if (stop.load(memory_order_relaxed)) return;
+    worker.solver.nodeCount++;
+    if (!worker.solver.propagate(state)) return;
+    if (state.emptyCells == 0) {
+        report(state.cells);
+        return;
+    }
+
+    Mask options = 0;
+    int cell = Search::chooseCell(state, options);
+    if (idle.load(memory_order_relaxed) > 0 && !isSingleBit(options)) {
+        Mask rest = options & (options - 1);
+        options &= ~rest;
+        {
+            lock_guard<mutex> guard(worker.lock);
+            for (; rest; rest &= rest - 1) {
+                State next = state;
+                if (!Search::place(next, cell, lowestBit(rest) + 1)) continue;
+                pending++;
+                queued++;
+                worker.tasks.push_back(next);
+            }
+        }
+        wakeIdle();
+    }
+    for (; options; options &= options - 1) {
+        State next = state;
+        if (Search::place(next, cell, lowestBit(options) + 1)) explore(worker, next);
+        if (stop.load(memory_order_relaxed)) return;
+    }
+}
+
+// Records a solution according to the search mode, raising the stop flag when it is the last one wanted.
+template <int BOX>
+void BasicParallelSolver<BOX>::report(const Grid& solution) {
+    if (mode == Mode::COUNT) {
+        if (found.fetch_add(1) + 1 >= limit) {
+            stop = true;
+            wakeIdle();
+        }
+        return;
+    }
+
+    lock_guard<mutex> guard(resultLock);
+    if (stop) return;
+    found++;
+    if (mode == Mode::SOLVE) {
+        result = solution;
+        stop = true;
+    } else if (!(*visitor)(solution)) {
+        stop = true;
+    }
+    if (stop) wakeIdle();
+}
+
+// Runs one search on every worker and returns the number of solutions found.
+template <int BOX>
+long long BasicParallelSolver<BOX>::run(const Grid& grid, Mode searchMode, long long searchLimit) {
+    mode = searchMode;
+    limit = max(1LL, searchLimit);
+    stop = false;
+    found = 0;
+    idle = 0;
+    queued = 1;
+    nodeCount = 0;
+    for (auto& worker : workers) worker->solver.nodeCount = 0;
+
+    State root;
+    if (!Search::loadState(grid, root)) return 0;
+    workers[0]->tasks.push_back(root);
+    pending = 1;
+
+    if (!threads.empty()) {
+        lock_guard<mutex> guard(jobLock);
+        busyHelpers = static_cast<unsigned>(threads.size());
+        generation++;
+    }
+    jobReady.notify_all();
+    work(0);
+    {
+        unique_lock<mutex> guard(jobLock);
+        jobDone.wait(guard, [&] { return busyHelpers == 0; });
+    }
+
+    // A stopped search leaves tasks behind.
+    for (auto& worker : workers) {
+        worker->tasks.clear();
+        nodeCount += worker->solver.nodeCount;
+    }
+    return found;
+}
+
+// Solves a flat grid in place; the grid is left untouched if there is no solution.
+template <int BOX>
+bool BasicParallelSolver<BOX>::solve(Grid& grid) {
+    if (run(grid, Mode::SOLVE, 1) == 0) return false;
+    grid = result;
+    return true;
+}
+
+// Counts solutions of a grid, stopping as soon as `limit` of them have been found.
+template <int BOX>
+int BasicParallelSolver<BOX>::countSolutions(const Grid& grid, int limit) {
+    return static_cast<int>(min<long long>(run(grid, Mode::COUNT, limit), max(1, limit)));
+}
+
+// Visits every solution until the visitor asks to stop. Calls to `visit` never overlap,
+// but the solutions come in no particular order.
+template <int BOX>
+long long BasicParallelSolver<BOX>::enumerateSolutions(const Grid& grid, const SolutionVisitor& visit) {
+    visitor = &visit;
+    long long visited = run(grid, Mode::ENUMERATE, 0);
+    visitor = nullptr;
+    return visited;
+}
+
+// Search nodes visited by all workers in the last solve or count.
+template <int BOX>
+long long BasicParallelSolver<BOX>::getNodeCount() const {
+    return nodeCount;
+}
+
+template <int BOX>
+unsigned BasicParallelSolver<BOX>::threadCount() const {
+    return static_cast<unsigned>(workers.size());
+}
+
+template class BasicParallelSolver<3>;
+template class BasicParallelSolver<4>;
+template class BasicParallelSolver<5>;
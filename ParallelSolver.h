@@ -0,0 +1,95 @@
+#ifndef PARALLEL_SOLVER_H
+#define PARALLEL_SOLVER_H
+
+#include "Solver.h"
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Runs the bitmask search for one puzzle on several threads. The search tree is cut into
+// tasks (a search state plus the branches under it): a worker that is exploring and sees
+// an idle worker pushes its untried branches onto its own deque, and idle workers steal
+// the oldest, shallowest task from another worker's deque; one that finds nothing after a
+// few tries sleeps until a task is pushed or the search ends. The first solution (or the
+// count limit) raises a stop flag that every worker checks at each node.
+// The workers are started once and wait between searches.
+template <int BOX>
+class BasicParallelSolver : public BasicSolverBackend<BOX> {
+public:
+    using Traits = GridTraits<BOX>;
+    using Grid = typename Traits::Grid;
+    using Mask = typename Traits::Mask;
+    using SolutionVisitor = typename BasicSolverBackend<BOX>::SolutionVisitor;
+
+    static constexpr int SIZE = Traits::SIZE;
+    static constexpr int SUBGRID_SIZE = Traits::SUBGRID_SIZE;
+    static constexpr int CELLS = Traits::CELLS;
+
+private:
+    using Search = BasicSolver<BOX>;
+    using State = typename Search::State;
+
+    enum class Mode { SOLVE, COUNT, ENUMERATE };
+
+    struct Worker {
+        Search solver;          // Propagation code and this worker's node count.
+        mutex lock;
+        deque<State> tasks;     // Own end at the back, thieves take from the front.
+    };
+
+    vector<unique_ptr<Worker>> workers;     // Worker 0 is the calling thread.
+    vector<thread> threads;
+
+    // Wakes the helper threads for each search and waits for them to finish it.
+    mutex jobLock;
+    condition_variable jobReady;
+    condition_variable jobDone;
+    unsigned long long generation;
+    unsigned busyHelpers;
+    bool shuttingDown;
+
+    // The search in progress.
+    Mode mode;
+    long long limit;
+    const SolutionVisitor* visitor;
+    atomic<bool> stop;
+    atomic<long long> pending;   // Tasks queued or being explored.
+    atomic<long long> queued;    // Tasks waiting in a deque.
+    atomic<int> idle;            // Workers looking for a task.
+    atomic<int> parked;          // Idle workers asleep on taskReady.
+    mutex idleLock;
+    condition_variable taskReady;    // New tasks, or the search is over.
+    atomic<long long> found;
+    mutex resultLock;
+    Grid result;
+    long long nodeCount;
+
+    void helperLoop(unsigned index);
+    void work(unsigned index);
+    bool takeTask(unsigned index, State& task);
+    void wakeIdle();
+    void explore(Worker& worker, State& state);
+    void report(const Grid& solution);
+    long long run(const Grid& grid, Mode searchMode, long long searchLimit);
+
+public:
+    explicit BasicParallelSolver(unsigned threadCount = 0);
+    ~BasicParallelSolver();
+    BasicParallelSolver(const BasicParallelSolver&) = delete;
+    BasicParallelSolver& operator=(const BasicParallelSolver&) = delete;
+
+    std::string name() const override;
+    bool solve(Grid& grid) override;
+    int countSolutions(const Grid& grid, int limit = 2) override;
+    long long enumerateSolutions(const Grid& grid, const SolutionVisitor& visit) override;
+    long long getNodeCount() const override;
+    unsigned threadCount() const;
+};
+
+using ParallelSolver = BasicParallelSolver<3>;
+
+#endif // PARALLEL_SOLVER_H
@@ -0,0 +1,131 @@
+#include "PuzzlePool.h"
+#include "DifficultyRater.h"
+#include <algorithm>
+using namespace std;
+
+// Constructor: Allocates `depth` slots per difficulty; the producer starts with start().
+PuzzlePool::PuzzlePool(size_t depth) : depth(max<size_t>(1, depth)), hits(0), misses(0), running(false) {
+    for (auto& queue : queues) {
+        queue.slots.resize(this->depth);
+    }
+}
+
+PuzzlePool::~PuzzlePool() {
+    stop();
+}
+
+// Starts the background producer (no-op if it is already running).
+void PuzzlePool::start() {
+    if (running.exchange(true)) return;
+    producer = thread(&PuzzlePool::produce, this);
+}
+
+// Stops the producer and waits for it to finish the puzzle it is working on.
+void PuzzlePool::stop() {
+    {
+        lock_guard<mutex> lock(wakeMutex);
+        if (!running.exchange(false)) return;
+    }
+    wake.notify_one();
+    if (producer.joinable()) producer.join();
+}
+
+// Number of cells to blank for each difficulty level (1 = Very Easy ... 4 = Hard).
+// Digging goes on past this count until the puzzle reaches its rating band.
+int PuzzlePool::cellsToRemove(int difficulty) {
+    switch (difficulty) {
+        case 1: return 4;
+        case 2: return 40;
+        case 3: return 50;
+        default: return 60;
+    }
+}
+
+// Builds a fresh puzzle synchronously. Holes that would need a technique above the
+// level's rating band are filled back in; a grid that never gets hard enough is
+// dropped and the next one tried.
+SudokuBoard PuzzlePool::generate(int difficulty) {
+    DifficultyRater::Band band = DifficultyRater::bandOf(difficulty);
+    int target = cellsToRemove(difficulty);
+    auto filter = [&](const SudokuBoard::Grid& puzzle, int removed) {
+        // Without an upper bound the rating only matters once the target is reached.
+        if (band.hardest == HintEngine::SOLUTION && removed < target) return SudokuBoard::Dig::KEEP;
+        HintEngine::Technique hardest = DifficultyRater::rate(puzzle).hardest;
+        if (hardest > band.hardest) return SudokuBoard::Dig::UNDO;
+        return removed >= target && hardest >= band.easiest ? SudokuBoard::Dig::STOP : SudokuBoard::Dig::KEEP;
+    };
+
+    SudokuBoard board;
+    for (int attempt = 0; attempt < MAX_ATTEMPTS; attempt++) {
+        board.generateRandomGrid();
+        board.removeNumbers(filter);
+        if (DifficultyRater::rate(board).hardest >= band.easiest) break;
+    }
+    return board;
+}
+
+// Returns the difficulty with the fewest ready puzzles, or -1 if every queue is full.
+int PuzzlePool::neediestDifficulty() const {
+    int neediest = -1;
+    size_t fewest = depth;
+    for (int i = 0; i < DIFFICULTIES; i++) {
+        size_t ready = available(i + 1);
+        if (ready < fewest) {
+            fewest = ready;
+            neediest = i;
+        }
+    }
+    return neediest;
+}
+
+// Producer loop: refills the emptiest queue, sleeps while all of them are full.
+void PuzzlePool::produce() {
+    while (running) {
+        int index = neediestDifficulty();
+        if (index < 0) {
+            unique_lock<mutex> lock(wakeMutex);
+            wake.wait(lock, [&] { return !running || neediestDifficulty() >= 0; });
+            continue;
+        }
+
+        Queue& queue = queues[index];
+        size_t tail = queue.tail.load(memory_order_relaxed);
+        queue.slots[tail % depth] = generate(index + 1);
+        queue.tail.store(tail + 1, memory_order_release);
+    }
+}
+
+// Pops a ready puzzle, or generates one on the spot when the queue is empty.
+SudokuBoard PuzzlePool::take(int difficulty) {
+    Queue& queue = queues[difficulty - 1];
+    size_t head = queue.head.load(memory_order_relaxed);
+    if (head == queue.tail.load(memory_order_acquire)) {
+        misses++;
+        return generate(difficulty);
+    }
+
+    SudokuBoard board = move(queue.slots[head % depth]);
+    queue.head.store(head + 1, memory_order_release);
+    hits++;
+    {
+        // Taking the lock orders this pop against the producer's "all full" check,
+        // so the wakeup below cannot be lost.
+        lock_guard<mutex> lock(wakeMutex);
+    }
+    wake.notify_one();
+    return board;
+}
+
+// Number of puzzles ready for a difficulty.
+size_t PuzzlePool::available(int difficulty) const {
+    const Queue& queue = queues[difficulty - 1];
+    return queue.tail.load(memory_order_acquire) - queue.head.load(memory_order_acquire);
+}
+
+long long PuzzlePool::getHits() const {
+    return hits;
+}
+
+long long PuzzlePool::getMisses() const {
+    return misses;
+}
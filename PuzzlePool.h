@@ -0,0 +1,55 @@
+#ifndef PUZZLE_POOL_H
+#define PUZZLE_POOL_H
+
+#include "SudokuBoard.h"
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Keeps a few ready-made puzzles per difficulty so a new game does not wait for generation.
+// A background thread tops up one single-producer/single-consumer ring per difficulty.
+class PuzzlePool {
+public:
+    static const int DIFFICULTIES = 4;
+    static const int MAX_ATTEMPTS = 50;   // Grids tried before settling for a puzzle outside its band.
+
+private:
+    struct Queue {
+        vector<SudokuBoard> slots;
+        atomic<size_t> head{0}; // Next slot to take (consumer side).
+        atomic<size_t> tail{0}; // Next slot to fill (producer side).
+    };
+
+    Queue queues[DIFFICULTIES];
+    size_t depth;
+    atomic<long long> hits;
+    atomic<long long> misses;
+
+    thread producer;
+    mutex wakeMutex;
+    condition_variable wake;
+    atomic<bool> running;
+
+    void produce();
+    int neediestDifficulty() const;
+
+public:
+    explicit PuzzlePool(size_t depth = 4);
+    ~PuzzlePool();
+    PuzzlePool(const PuzzlePool&) = delete;
+    PuzzlePool& operator=(const PuzzlePool&) = delete;
+
+    void start();
+    void stop();
+    SudokuBoard take(int difficulty);
+    size_t available(int difficulty) const;
+    long long getHits() const;
+    long long getMisses() const;
+
+    static int cellsToRemove(int difficulty);
+    static SudokuBoard generate(int difficulty);
+};
+
+#endif
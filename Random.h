@@ -0,0 +1,48 @@
+#ifndef RANDOM_H
+#define RANDOM_H
+
+#include <cstdint>
+#include <random>
+
+// xoshiro256** (Blackman and Vigna): a few instructions per number and no shared state,
+// so every generator or thread can own one. Usable wherever a URBG is expected.
+class Xoshiro256 {
+    uint64_t state[4];
+
+    static uint64_t rotl(uint64_t x, int k) { return (x << k) | (x >> (64 - k)); }
+
+public:
+    using result_type = uint64_t;
+
+    // Expands the seed with splitmix64, so nearby seeds give unrelated streams.
+    explicit Xoshiro256(uint64_t seed = std::random_device{}()) {
+        for (uint64_t& word : state) {
+            uint64_t z = (seed += 0x9e3779b97f4a7c15ULL);
+            z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+            z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+            word = z ^ (z >> 31);
+        }
+    }
+
+    static constexpr result_type min() { return 0; }
+    static constexpr result_type max() { return ~result_type(0); }
+
+    result_type operator()() {
+        uint64_t result = rotl(state[1] * 5, 7) * 9;
+        uint64_t t = state[1] << 17;
+        state[2] ^= state[0];
+        state[3] ^= state[1];
+        state[1] ^= state[2];
+        state[0] ^= state[3];
+        state[2] ^= t;
+        state[3] = rotl(state[3], 45);
+        return result;
+    }
+
+    // Uniform value in [0, bound) by multiply-shift; the bias is below 2^-32 for small bounds.
+    uint32_t below(uint32_t bound) {
+        return static_cast<uint32_t>(((*this)() >> 32) * bound >> 32);
+    }
+};
+
+#endif // RANDOM_H
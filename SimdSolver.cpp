@@ -0,0 +1,246 @@
+#include "SimdSolver.h"
+#include "BitUtils.h"
+#include <algorithm>
+using namespace std;
+
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+#define SUDOKU_HAS_SIMD 1
+#endif
+
+namespace {
+    using Traits = GridTraits<3>;
+    const int SIZE = Traits::SIZE;
+    const int CELLS = Traits::CELLS;
+    const int PEERS = Traits::PEERS;
+    const uint16_t ALL_DIGITS = Traits::ALL_DIGITS;
+
+#ifdef SUDOKU_HAS_SIMD
+    typedef uint16_t Lanes8 __attribute__((vector_size(16)));
+    typedef uint16_t Lanes16 __attribute__((vector_size(32)));
+
+    // Per-lane outcome of a vector pass: final candidate masks and a contradiction flag.
+    struct LaneResult {
+        uint16_t candidates[CELLS][SimdSolver::MAX_LANES];
+        bool failed[SimdSolver::MAX_LANES];
+    };
+
+    // Runs singles propagation on up to LANES puzzles at once. Every cell is one vector holding
+    // that cell's candidate mask for each puzzle; unused lanes carry an empty grid.
+    template <typename V, int LANES>
+    inline __attribute__((always_inline))
+    void propagateLanes(const SolverBackend::Grid* grids, int count, LaneResult& result) {
+        const V all = V{} + ALL_DIGITS;
+        V cand[CELLS];
+        V failed = V{};
+
+        for (int cell = 0; cell < CELLS; cell++) {
+            for (int lane = 0; lane < LANES; lane++) {
+                int value = lane < count ? grids[lane][cell] : 0;
+                // Out-of-range values get an empty mask and fail below.
+                cand[cell][lane] = value == 0 ? ALL_DIGITS : (value <= SIZE ? 1 << (value - 1) : 0);
+            }
+        }
+
+        for (int pass = 0; pass < CELLS; pass++) {
+            V changed = V{};
+
+            // Naked singles: a cell down to one candidate removes it from all its peers.
+            for (int cell = 0; cell < CELLS; cell++) {
+                V x = cand[cell];
+                V single = x & (V)((x & (x - 1)) == 0);
+                for (int k = 0; k < PEERS; k++) {
+                    int peer = gridTables<3>.peers[cell][k];
+                    V before = cand[peer];
+                    V after = before & ~single;
+                    changed |= before ^ after;
+                    cand[peer] = after;
+                }
+            }
+
+            // Hidden singles: a digit with exactly one place in a unit is fixed there.
+            for (int unit = 0; unit < Traits::UNITS; unit++) {
+                const auto* cells = gridTables<3>.units[unit];
+                V once = V{};
+                V twice = V{};
+                for (int i = 0; i < SIZE; i++) {
+                    V x = cand[cells[i]];
+                    twice |= once & x;
+                    once |= x;
+                }
+                failed |= once ^ all; // A digit with no place left.
+
+                V exactlyOnce = once & ~twice;
+                for (int i = 0; i < SIZE; i++) {
+                    V x = cand[cells[i]];
+                    V hidden = x & exactlyOnce;
+                    V take = (V)(hidden != 0);
+                    V next = (hidden & take) | (x & ~take);
+                    failed |= hidden & (hidden - 1); // Two digits forced into one cell.
+                    changed |= x ^ next;
+                    cand[cells[i]] = next;
+                }
+            }
+
+            for (int cell = 0; cell < CELLS; cell++) {
+                failed |= (V)(cand[cell] == 0);
+            }
+
+            V live = changed & (V)(failed == 0);
+            bool progress = false;
+            for (int lane = 0; lane < count; lane++) {
+                if (live[lane]) progress = true;
+            }
+            if (!progress) break;
+        }
+
+        for (int cell = 0; cell < CELLS; cell++) {
+            for (int lane = 0; lane < count; lane++) {
+                result.candidates[cell][lane] = cand[cell][lane];
+            }
+        }
+        for (int lane = 0; lane < count; lane++) {
+            result.failed[lane] = failed[lane] != 0;
+        }
+    }
+
+    __attribute__((target("avx2")))
+    void propagateAvx2(const SolverBackend::Grid* grids, int count, LaneResult& result) {
+        propagateLanes<Lanes16, 16>(grids, count, result);
+    }
+
+    __attribute__((target("sse2")))
+    void propagateSse2(const SolverBackend::Grid* grids, int count, LaneResult& result) {
+        propagateLanes<Lanes8, 8>(grids, count, result);
+    }
+#endif
+}
+
+// Constructor: Uses the widest vector unit the CPU supports.
+SimdSolver::SimdSolver() : SimdSolver(AVX2) {}
+
+// Constructor: Uses at most the requested instruction set (capped by what the CPU supports).
+SimdSolver::SimdSolver(Isa requested)
+    : isa(min(requested, detectIsa())),
+    nodeCount(0),
+    propagatedCount(0),
+    fallbackCount(0) {}
+
+// Checks at runtime which vector unit is available.
+SimdSolver::Isa SimdSolver::detectIsa() {
+#ifdef SUDOKU_HAS_SIMD
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) return AVX2;
+    if (__builtin_cpu_supports("sse2")) return SSE2;
+#endif
+    return SCALAR;
+}
+
+// Name used to select this engine at runtime.
+string SimdSolver::name() const {
+    return "simd";
+}
+
+// Solves one group of at most batchWidth() puzzles.
+void SimdSolver::solveGroup(Grid* grids, bool* solved, int count) {
+#ifdef SUDOKU_HAS_SIMD
+    if (isa != SCALAR) {
+        LaneResult result;
+        if (isa == AVX2) {
+            propagateAvx2(grids, count, result);
+        } else {
+            propagateSse2(grids, count, result);
+        }
+
+        for (int lane = 0; lane < count; lane++) {
+            // A contradiction reached by deduction alone means there is no solution.
+            if (result.failed[lane]) {
+                solved[lane] = false;
+                continue;
+            }
+
+            Grid partial;
+            bool complete = true;
+            for (int cell = 0; cell < CELLS; cell++) {
+                uint16_t mask = result.candidates[cell][lane];
+                partial[cell] = isSingleBit(mask) ? lowestBit(mask) + 1 : 0;
+                complete = complete && partial[cell] != 0;
+            }
+
+            if (complete) {
+                propagatedCount++;
+                solved[lane] = true;
+            } else {
+                // Singles were not enough; search from the propagated grid.
+                fallbackCount++;
+                solved[lane] = fallback.solve(partial);
+                nodeCount += fallback.getNodeCount();
+            }
+            if (solved[lane]) grids[lane] = partial;
+        }
+        return;
+    }
+#endif
+    for (int i = 0; i < count; i++) {
+        fallbackCount++;
+        solved[i] = fallback.solve(grids[i]);
+        nodeCount += fallback.getNodeCount();
+    }
+}
+
+// Solves `count` puzzles in place, one vector group at a time.
+void SimdSolver::solveMany(Grid* grids, bool* solved, int count) {
+    nodeCount = 0;
+    int width = batchWidth();
+    for (int start = 0; start < count; start += width) {
+        solveGroup(grids + start, solved + start, min(width, count - start));
+    }
+}
+
+// Solves a single puzzle (one lane of a group).
+bool SimdSolver::solve(Grid& grid) {
+    bool solved = false;
+    solveMany(&grid, &solved, 1);
+    return solved;
+}
+
+// Counting needs real search, so it always runs on the scalar engine.
+int SimdSolver::countSolutions(const Grid& grid, int limit) {
+    int found = fallback.countSolutions(grid, limit);
+    nodeCount = fallback.getNodeCount();
+    return found;
+}
+
+// Enumeration needs real search, so it always runs on the scalar engine.
+long long SimdSolver::enumerateSolutions(const Grid& grid, const SolutionVisitor& visit) {
+    long long found = fallback.enumerateSolutions(grid, visit);
+    nodeCount = fallback.getNodeCount();
+    return found;
+}
+
+// Scalar search nodes spent by the last call (vector propagation is not counted).
+long long SimdSolver::getNodeCount() const {
+    return nodeCount;
+}
+
+// Number of puzzles solved together in one vector pass.
+int SimdSolver::batchWidth() const {
+    switch (isa) {
+        case AVX2: return 16;
+        case SSE2: return 8;
+        default: return 1;
+    }
+}
+
+SimdSolver::Isa SimdSolver::getIsa() const {
+    return isa;
+}
+
+// Puzzles finished by vector propagation alone.
+long long SimdSolver::getPropagatedCount() const {
+    return propagatedCount;
+}
+
+// Puzzles that needed the scalar search.
+long long SimdSolver::getFallbackCount() const {
+    return fallbackCount;
+}
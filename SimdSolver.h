@@ -0,0 +1,42 @@
+#ifndef SIMD_SOLVER_H
+#define SIMD_SOLVER_H
+
+#include "Solver.h"
+
+// Multi-puzzle engine: packs the candidate masks of 8 (SSE2) or 16 (AVX2) puzzles into
+// vector lanes and runs naked/hidden single propagation on all of them at once.
+// Lanes that singles alone cannot finish are handed to the scalar Solver, which is
+// also used for everything when no vector unit is available at runtime.
+class SimdSolver : public SolverBackend {
+public:
+    enum Isa { SCALAR, SSE2, AVX2 };
+    static const int MAX_LANES = 16;
+
+private:
+    Isa isa;
+    Solver fallback;
+    long long nodeCount;
+    long long propagatedCount;
+    long long fallbackCount;
+
+    void solveGroup(Grid* grids, bool* solved, int count);
+
+public:
+    SimdSolver();
+    explicit SimdSolver(Isa requested);
+
+    std::string name() const override;
+    bool solve(Grid& grid) override;
+    int countSolutions(const Grid& grid, int limit = 2) override;
+    long long enumerateSolutions(const Grid& grid, const SolutionVisitor& visit) override;
+    long long getNodeCount() const override;
+    int batchWidth() const override;
+    void solveMany(Grid* grids, bool* solved, int count) override;
+
+    Isa getIsa() const;
+    long long getPropagatedCount() const;
+    long long getFallbackCount() const;
+    static Isa detectIsa();
+};
+
+#endif // SIMD_SOLVER_H
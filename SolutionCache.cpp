@@ -0,0 +1,218 @@
+#include "SolutionCache.h"
+#include "Solver.h"
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <vector>
+using namespace std;
+
+static const char MAGIC[8] = {'S', 'D', 'K', 'S', 'O', 'L', 'V', '\0'};
+
+// Constructor: Caches up to `maxEntries` puzzles (at least one), sharded once there are
+// enough entries for every shard to be worth its lock.
+SolutionCache::SolutionCache(size_t maxEntries) : capacity(max<size_t>(1, maxEntries)) {
+    shardCount = static_cast<int>(min<size_t>(MAX_SHARDS, max<size_t>(1, capacity / MIN_SHARD_SIZE)));
+    shards.reset(new Shard[shardCount]);
+    for (int i = 0; i < shardCount; i++) {
+        shards[i].capacity = capacity / shardCount + (static_cast<size_t>(i) < capacity % shardCount);
+    }
+}
+
+// splitmix64 over the cells, eight at a time.
+uint64_t SolutionCache::hash(const Grid& puzzle) {
+    uint64_t h = 0x9e3779b97f4a7c15ULL;
+    for (int cell = 0; cell < SolverBackend::CELLS; cell += 8) {
+        uint64_t word = 0;
+        memcpy(&word, puzzle.data() + cell, min(8, SolverBackend::CELLS - cell));
+        h ^= word + 0x9e3779b97f4a7c15ULL + (h << 6) + (h >> 2);
+        h = (h ^ (h >> 30)) * 0xbf58476d1ce4e5b9ULL;
+        h = (h ^ (h >> 27)) * 0x94d049bb133111ebULL;
+        h ^= h >> 31;
+    }
+    return h;
+}
+
+// The high bits pick the shard; the shard's hash map buckets on the low ones.
+SolutionCache::Shard& SolutionCache::shardOf(uint64_t key) const {
+    return shards[(key >> 32) % shardCount];
+}
+
+// Looks a puzzle up, marking it most recently used. On a hit `solvable` tells whether
+// it has a solution, and `solution` holds it if so.
+bool SolutionCache::lookup(const Grid& puzzle, Grid& solution, bool& solvable) {
+    uint64_t key = hash(puzzle);
+    Shard& shard = shardOf(key);
+    lock_guard<mutex> guard(shard.lock);
+    auto found = shard.index.find(key);
+    if (found == shard.index.end() || found->second->puzzle != puzzle) {
+        shard.misses++;
+        return false;
+    }
+    shard.order.splice(shard.order.begin(), shard.order, found->second);
+    shard.hits++;
+    solvable = found->second->solvable;
+    if (solvable) solution = found->second->solution;
+    return true;
+}
+
+// Remembers the result for a puzzle, evicting the least recently used entry when full.
+void SolutionCache::store(const Grid& puzzle, const Grid& solution, bool solvable) {
+    uint64_t key = hash(puzzle);
+    Shard& shard = shardOf(key);
+    lock_guard<mutex> guard(shard.lock);
+    auto found = shard.index.find(key);
+    if (found != shard.index.end()) {
+        // Same puzzle solved twice, or another puzzle with the same hash: keep the newest.
+        Entry& entry = *found->second;
+        entry.puzzle = puzzle;
+        entry.solution = solution;
+        entry.solvable = solvable;
+        shard.order.splice(shard.order.begin(), shard.order, found->second);
+        return;
+    }
+    if (shard.order.size() >= shard.capacity) {
+        shard.index.erase(shard.order.back().key);
+        shard.order.pop_back();
+        shard.evictions++;
+    }
+    shard.order.push_front({key, puzzle, solution, solvable});
+    shard.index[key] = shard.order.begin();
+}
+
+// Solves a grid in place through the cache: a repeated puzzle costs one lookup.
+// `cached`, if given, tells whether the answer came from the cache.
+bool SolutionCache::solve(Grid& grid, SolverBackend& solver, bool* cached) {
+    bool solvable = false;
+    Grid solution;
+    bool hit = lookup(grid, solution, solvable);
+    if (cached) *cached = hit;
+    if (hit) {
+        if (solvable) grid = solution;
+        return solvable;
+    }
+    Grid puzzle = grid;
+    solvable = solver.solve(grid);
+    store(puzzle, grid, solvable);
+    return solvable;
+}
+
+// Counters summed over the shards.
+SolutionCache::Stats SolutionCache::stats() const {
+    Stats total;
+    total.capacity = capacity;
+    for (int i = 0; i < shardCount; i++) {
+        lock_guard<mutex> guard(shards[i].lock);
+        total.hits += shards[i].hits;
+        total.misses += shards[i].misses;
+        total.evictions += shards[i].evictions;
+        total.size += shards[i].order.size();
+    }
+    return total;
+}
+
+// Drops every entry; the counters keep running.
+void SolutionCache::clear() {
+    for (int i = 0; i < shardCount; i++) {
+        lock_guard<mutex> guard(shards[i].lock);
+        shards[i].order.clear();
+        shards[i].index.clear();
+    }
+}
+
+// Checks a stored solution: givens in range, and a complete grid agreeing with them.
+// Records marked unsolvable are checked by load(). A damaged file must not turn into
+// wrong answers.
+static bool isConsistent(const SolutionCache::Record& record) {
+    if (record.solvable > 1) return false;
+    for (int cell = 0; cell < SolverBackend::CELLS; cell++) {
+        if (record.puzzle[cell] > SolverBackend::SIZE) return false;
+    }
+    if (!record.solvable) return true;
+
+    const auto& tables = gridTables<SolverBackend::SUBGRID_SIZE>;
+    uint16_t rows[SolverBackend::SIZE] = {}, cols[SolverBackend::SIZE] = {}, boxes[SolverBackend::SIZE] = {};
+    for (int cell = 0; cell < SolverBackend::CELLS; cell++) {
+        int num = record.solution[cell];
+        if (num < 1 || num > SolverBackend::SIZE) return false;
+        if (record.puzzle[cell] && record.puzzle[cell] != num) return false;
+        uint16_t bit = static_cast<uint16_t>(1 << (num - 1));
+        int row = tables.rowOf[cell], col = tables.colOf[cell], box = tables.boxOf[cell];
+        if ((rows[row] | cols[col] | boxes[box]) & bit) return false;
+        rows[row] |= bit;
+        cols[col] |= bit;
+        boxes[box] |= bit;
+    }
+    return true;
+}
+
+// Warm start: adds the entries saved in `path`, skipping any that fail the consistency
+// check. "No solution" cannot be checked by looking, so those puzzles are solved again;
+// they are rare, and a flipped solvable byte would otherwise hide a solution for good.
+// Returns false if the file is missing or not a cache file.
+bool SolutionCache::load(const string& path) {
+    Solver checker;
+    ifstream file(path, ios::binary);
+    Header header;
+    if (!file.read(reinterpret_cast<char*>(&header), sizeof(header))) return false;
+    if (memcmp(header.magic, MAGIC, sizeof(MAGIC)) != 0 || header.version != VERSION ||
+        header.recordSize != sizeof(Record)) {
+        return false;
+    }
+
+    vector<Record> records(4096);
+    for (uint64_t left = header.entries; left > 0; ) {
+        size_t batch = static_cast<size_t>(min<uint64_t>(left, records.size()));
+        file.read(reinterpret_cast<char*>(records.data()), batch * sizeof(Record));
+        batch = static_cast<size_t>(file.gcount()) / sizeof(Record);
+        if (batch == 0) break;
+        for (size_t i = 0; i < batch; i++) {
+            const Record& record = records[i];
+            if (!isConsistent(record)) continue;
+            Grid puzzle, solution;
+            memcpy(puzzle.data(), record.puzzle, sizeof(record.puzzle));
+            memcpy(solution.data(), record.solution, sizeof(record.solution));
+            bool solvable = record.solvable != 0;
+            if (!solvable) {
+                solution = puzzle;
+                solvable = checker.solve(solution);
+            }
+            store(puzzle, solution, solvable);
+        }
+        left -= batch;
+    }
+    return true;
+}
+
+// Writes every entry, least recently used first so that loading restores the order,
+// to a temporary file renamed over `path`.
+bool SolutionCache::save(const string& path) const {
+    vector<Record> records;
+    for (int i = 0; i < shardCount; i++) {
+        lock_guard<mutex> guard(shards[i].lock);
+        for (auto entry = shards[i].order.rbegin(); entry != shards[i].order.rend(); ++entry) {
+            Record record = {};
+            memcpy(record.puzzle, entry->puzzle.data(), sizeof(record.puzzle));
+            if (entry->solvable) memcpy(record.solution, entry->solution.data(), sizeof(record.solution));
+            record.solvable = entry->solvable;
+            records.push_back(record);
+        }
+    }
+
+    Header header = {};
+    memcpy(header.magic, MAGIC, sizeof(MAGIC));
+    header.version = VERSION;
+    header.recordSize = sizeof(Record);
+    header.entries = records.size();
+
+    string temporary = path + ".tmp";
+    {
+        ofstream file(temporary, ios::binary | ios::trunc);
+        file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        file.write(reinterpret_cast<const char*>(records.data()), records.size() * sizeof(Record));
+        if (!file) return false;
+    }
+    error_code error;
+    filesystem::rename(temporary, path, error);
+    return !error;
+}
@@ -0,0 +1,94 @@
+#ifndef SOLUTION_CACHE_H
+#define SOLUTION_CACHE_H
+
+#include "SolverBackend.h"
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+using namespace std;
+
+// Bounded LRU cache of solver results for 9x9 puzzles, keyed on a 64-bit hash of the
+// 81 cells. Entries keep the puzzle itself, so a hash collision is a miss rather than
+// a wrong answer, and unsolvable puzzles are remembered as such. Large caches are split
+// into shards with their own lock and LRU list, so batch workers rarely wait on each other.
+//
+// File layout (warm start): Header, then `entries` Records, least recently used first.
+class SolutionCache {
+public:
+    using Grid = SolverBackend::Grid;
+
+    struct Stats {
+        uint64_t hits = 0;
+        uint64_t misses = 0;
+        uint64_t evictions = 0;
+        size_t size = 0;
+        size_t capacity = 0;
+
+        double hitRate() const { return hits + misses ? double(hits) / (hits + misses) : 0; }
+    };
+
+    struct Header {
+        char magic[8];
+        uint32_t version;
+        uint32_t recordSize;
+        uint64_t entries;
+    };
+
+    struct Record {
+        uint8_t puzzle[SolverBackend::CELLS];
+        uint8_t solution[SolverBackend::CELLS];
+        uint8_t solvable;
+    };
+
+    static constexpr uint32_t VERSION = 1;
+    static const size_t DEFAULT_CAPACITY = 1 << 16;
+
+private:
+    static const int MAX_SHARDS = 16;
+    static const size_t MIN_SHARD_SIZE = 1024;
+
+    struct Entry {
+        uint64_t key;
+        Grid puzzle;
+        Grid solution;
+        bool solvable;
+    };
+
+    struct Shard {
+        mutable mutex lock;
+        list<Entry> order;      // Most recently used first.
+        unordered_map<uint64_t, list<Entry>::iterator> index;
+        size_t capacity = 0;
+        uint64_t hits = 0;
+        uint64_t misses = 0;
+        uint64_t evictions = 0;
+    };
+
+    unique_ptr<Shard[]> shards;
+    int shardCount;
+    size_t capacity;
+
+    Shard& shardOf(uint64_t key) const;
+
+public:
+    explicit SolutionCache(size_t maxEntries = DEFAULT_CAPACITY);
+    SolutionCache(const SolutionCache&) = delete;
+    SolutionCache& operator=(const SolutionCache&) = delete;
+
+    static uint64_t hash(const Grid& puzzle);
+
+    bool lookup(const Grid& puzzle, Grid& solution, bool& solvable);
+    void store(const Grid& puzzle, const Grid& solution, bool solvable);
+    bool solve(Grid& grid, SolverBackend& solver, bool* cached = nullptr);
+    Stats stats() const;
+    void clear();
+
+    bool load(const string& path);
+    bool save(const string& path) const;
+};
+
+#endif // SOLUTION_CACHE_H
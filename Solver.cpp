@@ -1,79 +1,285 @@
 #include "Solver.h"
+#include "BitUtils.h"
+#include <algorithm>
 #include <iostream>
 #include <iomanip>
 #include <limits>
+#include <sstream>
+#include <stdexcept>
 #include <unordered_set>
 using namespace std;
 
-bool Solver::isValid(const vector<vector<int>>& board, int row, int col, int num) const {
-    // Check row
-    for(int j = 0; j < SIZE; j++) {
-        if(board[row][j] == num) return false;
+template <int BOX, bool STATS>
+BasicSolver<BOX, STATS>::BasicSolver() : nodeCount(0) {}
+
+// Name used to select this engine at runtime.
+template <int BOX, bool STATS>
+string BasicSolver<BOX, STATS>::name() const {
+    return "bitmask";
+}
+
+// Builds the search state from a grid, rejecting out-of-range values and conflicting givens.
+template <int BOX, bool STATS>
+bool BasicSolver<BOX, STATS>::loadState(const Grid& grid, State& state) {
+    state.cells.fill(0);
+    for (int i = 0; i < SIZE; i++) {
+        state.rowUsed[i] = state.colUsed[i] = state.boxUsed[i] = 0;
     }
-    
-    // Check column
-    for(int i = 0; i < SIZE; i++) {
-        if(board[i][col] == num) return false;
+    state.emptyCells = CELLS;
+
+    for (int cell = 0; cell < CELLS; cell++) {
+        int num = grid[cell];
+        if (num == 0) continue;
+        if (num > SIZE || !place(state, cell, num)) return false;
     }
-    
-    // Check 3x3 box
-    int boxRow = row - row % SUBGRID_SIZE;
-    int boxCol = col - col % SUBGRID_SIZE;
-    for(int i = 0; i < SUBGRID_SIZE; i++) {
-        for(int j = 0; j < SUBGRID_SIZE; j++) {
-            if(board[boxRow + i][boxCol + j] == num) return false;
+    return true;
+}
+
+// Places a digit and updates the unit masks; fails if the digit is already used in a peer unit.
+template <int BOX, bool STATS>
+bool BasicSolver<BOX, STATS>::place(State& state, int cell, int num) {
+    const auto& tables = gridTables<BOX>;
+    Mask bit = Mask(1) << (num - 1);
+    int row = tables.rowOf[cell];
+    int col = tables.colOf[cell];
+    int box = tables.boxOf[cell];
+    if ((state.rowUsed[row] | state.colUsed[col] | state.boxUsed[box]) & bit) return false;
+
+    state.cells[cell] = num;
+    state.rowUsed[row] |= bit;
+    state.colUsed[col] |= bit;
+    state.boxUsed[box] |= bit;
+    state.emptyCells--;
+    return true;
+}
+
+// Digits still allowed in an empty cell.
+template <int BOX, bool STATS>
+inline typename BasicSolver<BOX, STATS>::Mask BasicSolver<BOX, STATS>::candidates(const State& state, int cell) {
+    const auto& tables = gridTables<BOX>;
+    return ALL_DIGITS & ~(state.rowUsed[tables.rowOf[cell]] |
+                          state.colUsed[tables.colOf[cell]] |
+                          state.boxUsed[tables.boxOf[cell]]);
+}
+
+// Fills naked and hidden singles until nothing changes; returns false on a contradiction.
+template <int BOX, bool STATS>
+bool BasicSolver<BOX, STATS>::propagate(State& state) {
+    const auto& tables = gridTables<BOX>;
+    bool changed = true;
+    while (changed && state.emptyCells > 0) {
+        changed = false;
+
+        // Naked singles: cells with exactly one candidate left.
+        for (int cell = 0; cell < CELLS; cell++) {
+            if (state.cells[cell] != 0) continue;
+            Mask mask = candidates(state, cell);
+            if (mask == 0) return false;
+            if (isSingleBit(mask)) {
+                place(state, cell, lowestBit(mask) + 1);
+                if constexpr (STATS) stats.propagations++;
+                changed = true;
+            }
+        }
+
+        // Hidden singles: digits that fit in only one cell of a unit.
+        for (int unit = 0; unit < Traits::UNITS; unit++) {
+            const auto* unitCells = tables.units[unit];
+            Mask masks[SIZE];
+            Mask used = 0, once = 0, twice = 0;
+            for (int i = 0; i < SIZE; i++) {
+                int cell = unitCells[i];
+                if (state.cells[cell] != 0) {
+                    used |= Mask(1) << (state.cells[cell] - 1);
+                    masks[i] = 0;
+                    continue;
+                }
+                masks[i] = candidates(state, cell);
+                twice |= once & masks[i];
+                once |= masks[i];
+            }
+            if ((once | used) != ALL_DIGITS) return false; // Some digit has nowhere to go.
+
+            Mask exactlyOnce = once & ~twice;
+            if (exactlyOnce == 0) continue;
+            for (int i = 0; i < SIZE; i++) {
+                Mask hidden = masks[i] & exactlyOnce;
+                if (hidden == 0) continue;
+                if (!isSingleBit(hidden)) return false; // Two digits forced into one cell.
+                if (!place(state, unitCells[i], lowestBit(hidden) + 1)) return false;
+                if constexpr (STATS) stats.propagations++;
+                changed = true;
+            }
         }
     }
-    
     return true;
 }
 
-bool Solver::findEmptyCell(const vector<vector<int>>& board, int& row, int& col) const {
-    for(row = 0; row < SIZE; row++) {
-        for(col = 0; col < SIZE; col++) {
-            if(board[row][col] == 0) return true;
+// Picks the empty cell with the fewest candidates (returns -1 if the grid is full).
+template <int BOX, bool STATS>
+int BasicSolver<BOX, STATS>::chooseCell(const State& state, Mask& best) {
+    int bestCell = -1;
+    int bestCount = SIZE + 1;
+    for (int cell = 0; cell < CELLS; cell++) {
+        if (state.cells[cell] != 0) continue;
+        Mask mask = candidates(state, cell);
+        int count = bitCount(mask);
+        if (count < bestCount) {
+            bestCell = cell;
+            bestCount = count;
+            best = mask;
+            if (count <= 2) break;
         }
     }
-    return false;
+    return bestCell;
 }
 
-bool Solver::solveHelper(vector<vector<int>>& board, int row, int col) {
-    // If we've filled all cells, we're done
-    if(row == SIZE - 1 && col == SIZE) return true;
-    
-    // Move to next row if we've reached end of current row
-    if(col == SIZE) {
-        row++;
-        col = 0;
+// Counts a search node (and its depth when statistics are enabled).
+template <int BOX, bool STATS>
+inline void BasicSolver<BOX, STATS>::enterNode(int depth) {
+    nodeCount++;
+    if constexpr (STATS) {
+        stats.nodes++;
+        stats.maxDepth = max(stats.maxDepth, depth);
     }
-    
-    // Skip if cell is already filled
-    if(board[row][col] != 0) {
-        return solveHelper(board, row, col + 1);
+}
+
+// Resets the counters at the start of a public solve/count call. Only an instrumented
+// solver reads the clock.
+template <int BOX, bool STATS>
+void BasicSolver<BOX, STATS>::beginStats() {
+    nodeCount = 0;
+    if constexpr (STATS) {
+        stats.reset();
+        stats.solves = 1;
+        started = chrono::steady_clock::now();
     }
-    
-    // Try digits 1-9 in current cell
-    for(int num = 1; num <= 9; num++) {
-        if(isValid(board, row, col, num)) {
-            board[row][col] = num;
-            
-            if(solveHelper(board, row, col + 1)) return true;
-            
-            // If placing num didn't lead to a solution, backtrack
-            board[row][col] = 0;
-        }
+}
+
+// Records the wall time of a public solve/count call.
+template <int BOX, bool STATS>
+void BasicSolver<BOX, STATS>::endStats() {
+    if constexpr (STATS) {
+        stats.seconds = chrono::duration<double>(chrono::steady_clock::now() - started).count();
+    }
+}
+
+// Depth-first search with propagation at every node; copies the state per branch.
+template <int BOX, bool STATS>
+bool BasicSolver<BOX, STATS>::search(State& state, Grid& result, int depth) {
+    enterNode(depth);
+    if (!propagate(state)) return false;
+    if (state.emptyCells == 0) {
+        result = state.cells;
+        return true;
+    }
+
+    Mask options = 0;
+    int cell = chooseCell(state, options);
+    for (; options; options &= options - 1) {
+        State next = state;
+        if constexpr (STATS) stats.guesses++;
+        if (place(next, cell, lowestBit(options) + 1) && search(next, result, depth + 1)) return true;
+        if constexpr (STATS) stats.backtracks++;
     }
     return false;
 }
 
-bool Solver::solve(vector<vector<int>>& board) {
-    int row = 0, col = 0;
-    return solveHelper(board, row, col);
+// Same search as above, but hands every solution to `visit` until it returns false.
+template <int BOX, bool STATS>
+template <typename Visit>
+bool BasicSolver<BOX, STATS>::enumerate(State& state, Visit& visit, int depth) {
+    enterNode(depth);
+    if (!propagate(state)) return true;
+    if (state.emptyCells == 0) return visit(state.cells);
+
+    Mask options = 0;
+    int cell = chooseCell(state, options);
+    for (; options; options &= options - 1) {
+        State next = state;
+        if constexpr (STATS) stats.guesses++;
+        if (place(next, cell, lowestBit(options) + 1) && !enumerate(next, visit, depth + 1)) return false;
+        if constexpr (STATS) stats.backtracks++;
+    }
+    return true;
+}
+
+// Solves a flat grid in place; the grid is left untouched if there is no solution.
+template <int BOX, bool STATS>
+bool BasicSolver<BOX, STATS>::solve(Grid& grid) {
+    beginStats();
+    State state;
+    bool solved = loadState(grid, state) && search(state, grid, 0);
+    endStats();
+    return solved;
+}
+
+// Solves a board in place; the board is left untouched if there is no solution.
+template <int BOX, bool STATS>
+bool BasicSolver<BOX, STATS>::solve(vector<vector<int>>& board) {
+    if (board.size() != SIZE) return false;
+    Grid grid;
+    for (int i = 0; i < SIZE; i++) {
+        if (board[i].size() != SIZE) return false;
+        for (int j = 0; j < SIZE; j++) {
+            if (board[i][j] < 0 || board[i][j] > SIZE) return false;
+            grid[i * SIZE + j] = board[i][j];
+        }
+    }
+
+    if (!solve(grid)) return false;
+    for (int i = 0; i < SIZE; i++)
+        for (int j = 0; j < SIZE; j++)
+            board[i][j] = grid[i * SIZE + j];
+    return true;
+}
+
+// Counts solutions of a grid, stopping as soon as `limit` of them have been found.
+template <int BOX, bool STATS>
+int BasicSolver<BOX, STATS>::countSolutions(const Grid& grid, int limit) {
+    beginStats();
+    State state;
+    int found = 0;
+    auto visit = [&](const Grid&) { return ++found < limit; };
+    if (loadState(grid, state)) enumerate(state, visit, 0);
+    endStats();
+    return found;
+}
+
+// Visits every solution of a grid until the visitor asks to stop.
+template <int BOX, bool STATS>
+long long BasicSolver<BOX, STATS>::enumerateSolutions(const Grid& grid, const SolutionVisitor& visit) {
+    beginStats();
+    State state;
+    long long found = 0;
+    auto counted = [&](const Grid& solution) {
+        found++;
+        return visit(solution);
+    };
+    if (loadState(grid, state)) enumerate(state, counted, 0);
+    endStats();
+    return found;
+}
+
+// Number of search nodes visited by the last solve or count.
+template <int BOX, bool STATS>
+long long BasicSolver<BOX, STATS>::getNodeCount() const {
+    return nodeCount;
+}
+
+// Statistics of the last search; only instrumented solvers (STATS = true) have them.
+template <int BOX, bool STATS>
+const SolverStats* BasicSolver<BOX, STATS>::getStats() const {
+    return STATS ? &stats : nullptr;
 }
 
-void Solver::inputPuzzle(vector<vector<int>>& board) {
+template <int BOX, bool STATS>
+void BasicSolver<BOX, STATS>::inputPuzzle(vector<vector<int>>& board) {
     cout << "\nEnter the Sudoku puzzle, row by row (use 0 for empty cells):\n";
-    cout << "Example format for each row: 5 3 0 0 7 0 0 0 0\n\n";
+    const int example[] = {5, 3, 0, 0, 7};
+    cout << "Example format for each row:";
+    for (int j = 0; j < SIZE; j++) cout << " " << (j < 5 ? example[j] : 0);
+    cout << "\n\n";
     
     // Инициализация двумерного вектора
     board = vector<vector<int>>(SIZE, vector<int>(SIZE));
@@ -82,7 +288,7 @@ void Solver::inputPuzzle(vector<vector<int>>& board) {
         while (true) {
             cout << "Enter row " << i + 1 << ": ";
             string rowInput;
-            getline(cin, rowInput);
+            if (!getline(cin, rowInput)) throw runtime_error("End of input");
             stringstream ss(rowInput);
             vector<int> row;
             unordered_set<int> seenNumbers;
@@ -90,8 +296,8 @@ void Solver::inputPuzzle(vector<vector<int>>& board) {
             int value;
             
             while (ss >> value) {
-                if (value < 0 || value > 9) {
-                    cout << "Invalid input! Please enter numbers between 0-9.\n";
+                if (value < 0 || value > SIZE) {
+                    cout << "Invalid input! Please enter numbers between 0-" << SIZE << ".\n";
                     row.clear();
                     break;
                 }
@@ -103,7 +309,7 @@ void Solver::inputPuzzle(vector<vector<int>>& board) {
             
             // Проверка на количество значений в строке
             if (row.size() != SIZE) {
-                cout << "Invalid input! Each row must contain exactly 9 numbers.\n";
+                cout << "Invalid input! Each row must contain exactly " << SIZE << " numbers.\n";
                 continue;
             }
             
@@ -121,34 +327,39 @@ void Solver::inputPuzzle(vector<vector<int>>& board) {
     }
 }
 
-void Solver::printBoard(const vector<vector<int>>& board) const {
-    cout << "\n   ";
+template <int BOX, bool STATS>
+void BasicSolver<BOX, STATS>::printBoard(const vector<vector<int>>& board) const {
+    const int width = SIZE > 9 ? 2 : 1; // Characters per cell value.
+    const int lineLength = SIZE * (width + 1) + 3;
+
+    cout << "\n" << string(width + 2, ' ');
     for (int j = 0; j < SIZE; j++) {
-        cout << j + 1 << " ";
+        cout << setw(width) << j + 1 << " ";
         if ((j + 1) % SUBGRID_SIZE == 0 && j != SIZE - 1) cout << "  ";
     }
-    cout << "\n   ";
-    for (int j = 0; j < SIZE * 2 + 3; j++) cout << "-";
-    cout << "\n";
+    cout << "\n" << string(width + 2, ' ') << string(lineLength, '-') << "\n";
 
     for (int i = 0; i < SIZE; i++) {
-        cout << i + 1 << "| ";
+        cout << setw(width) << i + 1 << "| ";
         for (int j = 0; j < SIZE; j++) {
             if (board[i][j] == 0) {
-                cout << "_ ";
+                cout << string(width - 1, ' ') << "_ ";
             } else {
-                cout << board[i][j] << " ";
+                cout << setw(width) << board[i][j] << " ";
             }
             if ((j + 1) % SUBGRID_SIZE == 0 && j != SIZE - 1) cout << "| ";
         }
         cout << "|\n";
         if ((i + 1) % SUBGRID_SIZE == 0 && i != SIZE - 1) {
-            cout << "   ";
-            for (int j = 0; j < SIZE * 2 + 3; j++) cout << "-";
-            cout << "\n";
+            cout << string(width + 2, ' ') << string(lineLength, '-') << "\n";
         }
     }
-    cout << "   ";
-    for (int j = 0; j < SIZE * 2 + 3; j++) cout << "-";
-    cout << "\n";
-}
\ No newline at end of file
+    cout << string(width + 2, ' ') << string(lineLength, '-') << "\n";
+}
+
+template class BasicSolver<3>;
+template class BasicSolver<4>;
+template class BasicSolver<5>;
+template class BasicSolver<3, true>;
+template class BasicSolver<4, true>;
+template class BasicSolver<5, true>;
\ No newline at end of file
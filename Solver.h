@@ -1,22 +1,72 @@
 #ifndef SOLVER_H
 #define SOLVER_H
 
+#include <array>
+#include <chrono>
+#include <cstdint>
 #include <vector>
 #include "SudokuBoard.h"
+#include "SolverBackend.h"
+#include "SolverStats.h"
+
+// Bitmask propagation solver. With STATS = true every search fills a SolverStats;
+// with the default STATS = false the counting code is compiled out entirely.
+template <int BOX, bool STATS = false>
+class BasicSolver : public BasicSolverBackend<BOX> {
+public:
+    using Traits = GridTraits<BOX>;
+    using Grid = typename Traits::Grid;
+    using Mask = typename Traits::Mask;
+    using SolutionVisitor = typename BasicSolverBackend<BOX>::SolutionVisitor;
+
+    static constexpr int SIZE = Traits::SIZE;
+    static constexpr int SUBGRID_SIZE = Traits::SUBGRID_SIZE;
+    static constexpr int CELLS = Traits::CELLS;
 
-class Solver {
 private:
-    static const int SIZE = 9;
-    static const int SUBGRID_SIZE = 3;
-    
-    bool isValid(const std::vector<std::vector<int>>& board, int row, int col, int num) const;
-    bool findEmptyCell(const std::vector<std::vector<int>>& board, int& row, int& col) const;
-    bool solveHelper(std::vector<std::vector<int>>& board, int row, int col);
+    template <int> friend class BasicParallelSolver;   // Splits this search across threads.
+
+    static constexpr Mask ALL_DIGITS = Traits::ALL_DIGITS;
+
+    // Search state: the grid plus one "digits used" mask per row, column and box.
+    struct State {
+        Grid cells;
+        Mask rowUsed[SIZE];
+        Mask colUsed[SIZE];
+        Mask boxUsed[SIZE];
+        int emptyCells;
+    };
+
+    long long nodeCount;
+    SolverStats stats;
+    std::chrono::steady_clock::time_point started;  // Set only when STATS is true.
+
+    static bool loadState(const Grid& grid, State& state);
+    static bool place(State& state, int cell, int num);
+    static Mask candidates(const State& state, int cell);
+    bool propagate(State& state);
+    static int chooseCell(const State& state, Mask& best);
+    void enterNode(int depth);
+    void beginStats();
+    void endStats();
+    bool search(State& state, Grid& result, int depth);
+    template <typename Visit>
+    bool enumerate(State& state, Visit& visit, int depth);
 
 public:
+    BasicSolver();
+    std::string name() const override;
+    bool solve(Grid& grid) override;
     bool solve(std::vector<std::vector<int>>& board);
+    int countSolutions(const Grid& grid, int limit = 2) override;
+    long long enumerateSolutions(const Grid& grid, const SolutionVisitor& visit) override;
+    long long getNodeCount() const override;
+    const SolverStats* getStats() const override;
     void inputPuzzle(std::vector<std::vector<int>>& board);
     void printBoard(const vector<vector<int>>& board) const;
 };
 
-#endif // SOLVER_H
\ No newline at end of file
+using Solver = BasicSolver<3>;
+using InstrumentedSolver = BasicSolver<3, true>;
+
+#endif // SOLVER_H
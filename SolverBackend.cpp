@@ -0,0 +1,31 @@
+#include "SolverBackend.h"
+#include "Solver.h"
+#include "DlxSolver.h"
+#include "SimdSolver.h"
+#include "ParallelSolver.h"
+using namespace std;
+
+// Creates a solver engine by name; returns nullptr for unknown names.
+// `instrumented` asks for an engine that fills SolverStats (where one exists).
+template <int BOX>
+unique_ptr<BasicSolverBackend<BOX>> BasicSolverBackend<BOX>::create(const string& name, bool instrumented) {
+    if (name == "bitmask" && instrumented) return unique_ptr<BasicSolverBackend>(new BasicSolver<BOX, true>());
+    if (name == "bitmask") return unique_ptr<BasicSolverBackend>(new BasicSolver<BOX>());
+    if (name == "dlx") return unique_ptr<BasicSolverBackend>(new BasicDlxSolver<BOX>());
+    if (name == "parallel") return unique_ptr<BasicSolverBackend>(new BasicParallelSolver<BOX>());
+    if constexpr (BOX == 3) {
+        if (name == "simd") return unique_ptr<BasicSolverBackend>(new SimdSolver());
+    }
+    return nullptr;
+}
+
+// Names accepted by create(), default first.
+template <int BOX>
+vector<string> BasicSolverBackend<BOX>::available() {
+    if constexpr (BOX == 3) return {"bitmask", "dlx", "simd", "parallel"};
+    return {"bitmask", "dlx", "parallel"};
+}
+
+template class BasicSolverBackend<3>;
+template class BasicSolverBackend<4>;
+template class BasicSolverBackend<5>;
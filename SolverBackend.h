@@ -0,0 +1,48 @@
+#ifndef SOLVER_BACKEND_H
+#define SOLVER_BACKEND_H
+
+#include "GridTraits.h"
+#include "SolverStats.h"
+#include <array>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+// Common interface of the solver engines so callers can pick one at runtime.
+template <int BOX>
+class BasicSolverBackend {
+public:
+    using Traits = GridTraits<BOX>;
+    static constexpr int SIZE = Traits::SIZE;
+    static constexpr int SUBGRID_SIZE = Traits::SUBGRID_SIZE;
+    static constexpr int CELLS = Traits::CELLS;
+
+    using Grid = typename Traits::Grid;
+    using SolutionVisitor = std::function<bool(const Grid&)>;
+
+    virtual ~BasicSolverBackend() {}
+
+    virtual std::string name() const = 0;
+    virtual bool solve(Grid& grid) = 0;
+    virtual int countSolutions(const Grid& grid, int limit = 2) = 0;
+    // Calls `visit` for every solution until it returns false; returns the number visited.
+    virtual long long enumerateSolutions(const Grid& grid, const SolutionVisitor& visit) = 0;
+    virtual long long getNodeCount() const = 0;
+    // Statistics of the last search, or nullptr if this engine is not instrumented.
+    virtual const SolverStats* getStats() const { return nullptr; }
+
+    // Bulk interface: engines that solve several puzzles at once report their group size.
+    virtual int batchWidth() const { return 1; }
+    virtual void solveMany(Grid* grids, bool* solved, int count) {
+        for (int i = 0; i < count; i++) solved[i] = solve(grids[i]);
+    }
+
+    static std::unique_ptr<BasicSolverBackend> create(const std::string& name, bool instrumented = false);
+    static std::vector<std::string> available();
+};
+
+using SolverBackend = BasicSolverBackend<3>;
+
+#endif // SOLVER_BACKEND_H
@@ -0,0 +1,31 @@
+#include "SolverStats.h"
+#include <algorithm>
+#include <iomanip>
+#include <ostream>
+using namespace std;
+
+void SolverStats::reset() {
+    *this = SolverStats();
+}
+
+// Adds another solve's counters; the depth is the maximum of both.
+void SolverStats::add(const SolverStats& other) {
+    solves += other.solves;
+    nodes += other.nodes;
+    guesses += other.guesses;
+    backtracks += other.backtracks;
+    propagations += other.propagations;
+    maxDepth = max(maxDepth, other.maxDepth);
+    seconds += other.seconds;
+}
+
+// Prints the counters in a compact, human-readable form.
+void SolverStats::print(ostream& out) const {
+    out << "Search: " << nodes << " nodes, "
+        << guesses << " guesses, "
+        << backtracks << " backtracks, "
+        << propagations << " propagated digits, max depth " << maxDepth << "\n"
+        << "Solve time: " << fixed << setprecision(3) << seconds * 1000 << " ms";
+    if (solves > 1) out << " over " << solves << " solves";
+    out << "\n";
+}
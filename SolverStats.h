@@ -0,0 +1,22 @@
+#ifndef SOLVER_STATS_H
+#define SOLVER_STATS_H
+
+#include <iosfwd>
+
+// Search statistics gathered by an instrumented solver (see BasicSolver's STATS parameter).
+// One instance describes one solve; add() merges several solves for batch reports.
+struct SolverStats {
+    long long solves = 0;
+    long long nodes = 0;         // Recursive search calls.
+    long long guesses = 0;       // Branch digits tried at a choice point.
+    long long backtracks = 0;    // Branches that ended in a contradiction.
+    long long propagations = 0;  // Digits placed by naked/hidden singles.
+    int maxDepth = 0;
+    double seconds = 0;
+
+    void reset();
+    void add(const SolverStats& other);
+    void print(std::ostream& out) const;
+};
+
+#endif // SOLVER_STATS_H
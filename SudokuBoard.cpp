@@ -1,125 +1,214 @@
 #include "SudokuBoard.h"
+#include "Solver.h"
+#include "GridGenerator.h"
 #include <algorithm>
-#include <cstdlib>
-#include <ctime>
-#include <random>
+#include <iomanip>
 #include <iostream>
+#include <type_traits>
 using namespace std;
 
-// Constructor: Initializes the Sudoku board and supporting structures.
-SudokuBoard::SudokuBoard() : 
-    board(SIZE, vector<int>(SIZE, 0)),
-    solution(SIZE, vector<int>(SIZE, 0)),
-    rowUsed(SIZE),
-    colUsed(SIZE),
-    boxUsed(SIZE) {}
+// Constructor: Initializes an empty board with no givens.
+template <int BOX>
+BasicSudokuBoard<BOX>::BasicSudokuBoard() {
+    board.fill(0);
+    solution.fill(0);
+    rowUsed.fill(0);
+    colUsed.fill(0);
+    boxUsed.fill(0);
+    filledCount = 0;
+    mismatchCount = 0;
+}
 
 // Updates bitsets used to track which numbers are already present in rows, columns, and boxes.
-void SudokuBoard::updateBitsets(int row, int col, int num, bool setValue) {
-    rowUsed[row][num-1] = setValue;
-    colUsed[col][num-1] = setValue;
-    boxUsed[(row/3)*3 + col/3][num-1] = setValue;
+template <int BOX>
+void BasicSudokuBoard<BOX>::updateBitsets(int row, int col, int num, bool setValue) {
+    Mask bit = Mask(1) << (num - 1);
+    int box = boxIndex(row, col);
+    if (setValue) {
+        rowUsed[row] |= bit;
+        colUsed[col] |= bit;
+        boxUsed[box] |= bit;
+    } else {
+        rowUsed[row] &= ~bit;
+        colUsed[col] &= ~bit;
+        boxUsed[box] &= ~bit;
+    }
+}
+
+// Writes one cell and keeps the filled, mismatch and wrong-cell tracking in step.
+template <int BOX>
+void BasicSudokuBoard<BOX>::setCell(int cell, int num) {
+    filledCount += (num != 0) - (board[cell] != 0);
+    mismatchCount += (num != solution[cell]) - (board[cell] != solution[cell]);
+    board[cell] = num;
+    wrongCells[cell] = num != 0 && num != solution[cell];
+}
+
+// Recomputes the cell tracking from scratch after the board or solution is replaced.
+template <int BOX>
+void BasicSudokuBoard<BOX>::recountCells() {
+    filledCount = 0;
+    mismatchCount = 0;
+    wrongCells.reset();
+    for (int cell = 0; cell < CELLS; cell++) {
+        filledCount += board[cell] != 0;
+        mismatchCount += board[cell] != solution[cell];
+        wrongCells[cell] = board[cell] != 0 && board[cell] != solution[cell];
+    }
 }
 
 // Initializes bitsets based on the current board state.
-void SudokuBoard::initializeBitsets() {
-    rowUsed = vector<bitset<9>>(9, bitset<9>());
-    colUsed = vector<bitset<9>>(9, bitset<9>());
-    boxUsed = vector<bitset<9>>(9, bitset<9>());
+template <int BOX>
+void BasicSudokuBoard<BOX>::initializeBitsets() {
+    rowUsed.fill(0);
+    colUsed.fill(0);
+    boxUsed.fill(0);
     
     for(int i = 0; i < SIZE; i++) {
         for(int j = 0; j < SIZE; j++) {
-            if(board[i][j] != 0) {
-                updateBitsets(i, j, board[i][j], true);
+            if(board[cellIndex(i, j)] != 0) {
+                updateBitsets(i, j, board[cellIndex(i, j)], true);
             }
         }
     }
+    recountCells();
 }
 
-// Fills the board with a base valid Sudoku grid.
-void SudokuBoard::generateBaseGrid() {
-    const int base[SIZE][SIZE] = {
-        {1, 2, 3, 4, 5, 6, 7, 8, 9},
-        {4, 5, 6, 7, 8, 9, 1, 2, 3},
-        {7, 8, 9, 1, 2, 3, 4, 5, 6},
-        {2, 3, 4, 5, 6, 7, 8, 9, 1},
-        {5, 6, 7, 8, 9, 1, 2, 3, 4},
-        {8, 9, 1, 2, 3, 4, 5, 6, 7},
-        {3, 4, 5, 6, 7, 8, 9, 1, 2},
-        {6, 7, 8, 9, 1, 2, 3, 4, 5},
-        {9, 1, 2, 3, 4, 5, 6, 7, 8}
-    };
-
+// Fills the board with a base valid Sudoku grid: each row is the first row shifted by
+// one box width, plus one more step at every new band (1 2 3 ..., 4 5 6 ..., 7 8 9 ..., 2 3 4 ...).
+template <int BOX>
+void BasicSudokuBoard<BOX>::generateBaseGrid() {
     for(int i = 0; i < SIZE; i++)
         for(int j = 0; j < SIZE; j++)
-            board[i][j] = base[i][j];
+            board[cellIndex(i, j)] = (SUBGRID_SIZE * (i % SUBGRID_SIZE) + i / SUBGRID_SIZE + j) % SIZE + 1;
             
     initializeBitsets();
 }
 
+// Each thread builds boards with its own generator, so nothing is shared or locked.
+template <int BOX>
+static BasicGridGenerator<BOX>& localGenerator() {
+    thread_local BasicGridGenerator<BOX> generator;
+    return generator;
+}
+
+// Fills the board with a random complete grid; the default way to start a new puzzle.
+template <int BOX>
+void BasicSudokuBoard<BOX>::generateRandomGrid() {
+    localGenerator<BOX>().generate(board);
+    rowUsed.fill(Traits::ALL_DIGITS);
+    colUsed.fill(Traits::ALL_DIGITS);
+    boxUsed.fill(Traits::ALL_DIGITS);
+    recountCells();
+}
+
+// Swaps two cells together with their solution, given and wrong-cell state,
+// so the transforms below keep the cell tracking valid without a recount.
+template <int BOX>
+void BasicSudokuBoard<BOX>::swapCells(int cell1, int cell2) {
+    swap(board[cell1], board[cell2]);
+    swap(solution[cell1], solution[cell2]);
+    bool given = givens[cell1];
+    givens[cell1] = givens[cell2];
+    givens[cell2] = given;
+    bool wrong = wrongCells[cell1];
+    wrongCells[cell1] = wrongCells[cell2];
+    wrongCells[cell2] = wrong;
+}
+
+// Swaps two whole rows of the grid (the caller fixes the box masks if they change bands).
+template <int BOX>
+void BasicSudokuBoard<BOX>::swapRows(int row1, int row2) {
+    for (int j = 0; j < SIZE; j++) {
+        swapCells(cellIndex(row1, j), cellIndex(row2, j));
+    }
+    swap(rowUsed[row1], rowUsed[row2]);
+}
+
+// Swaps two whole columns of the grid (the caller fixes the box masks if they change stacks).
+template <int BOX>
+void BasicSudokuBoard<BOX>::swapCols(int col1, int col2) {
+    for (int i = 0; i < SIZE; i++) {
+        swapCells(cellIndex(i, col1), cellIndex(i, col2));
+    }
+    swap(colUsed[col1], colUsed[col2]);
+}
+
 // Transposes the board (swaps rows with columns) to create a new variation.
-void SudokuBoard::transpose() {
+template <int BOX>
+void BasicSudokuBoard<BOX>::transpose() {
     for(int i = 0; i < SIZE; i++) {
         for(int j = i + 1; j < SIZE; j++) {
-            swap(board[i][j], board[j][i]);
+            swapCells(cellIndex(i, j), cellIndex(j, i));
+        }
+    }
+    swap(rowUsed, colUsed);
+    for (int i = 0; i < SUBGRID_SIZE; i++) {
+        for (int j = i + 1; j < SUBGRID_SIZE; j++) {
+            swap(boxUsed[i * SUBGRID_SIZE + j], boxUsed[j * SUBGRID_SIZE + i]);
         }
     }
-    initializeBitsets();
 }
 
 // Swaps two rows within the same subgrid.
-void SudokuBoard::swapRowsInBlock() {
-    int block = rand() % SUBGRID_SIZE;
-    int row1 = block * SUBGRID_SIZE + rand() % SUBGRID_SIZE;
-    int row2 = block * SUBGRID_SIZE + rand() % SUBGRID_SIZE;
+template <int BOX>
+void BasicSudokuBoard<BOX>::swapRowsInBlock() {
+    Xoshiro256& rng = localGenerator<BOX>().random();
+    int block = rng.below(SUBGRID_SIZE);
+    int row1 = block * SUBGRID_SIZE + rng.below(SUBGRID_SIZE);
+    int row2 = block * SUBGRID_SIZE + rng.below(SUBGRID_SIZE);
     if(row1 != row2) {
-        swap(board[row1], board[row2]);
+        swapRows(row1, row2);
     }
-    initializeBitsets();
 }
 
 // Swaps two columns within the same subgrid.
-void SudokuBoard::swapColsInBlock() {
-    int block = rand() % SUBGRID_SIZE;
-    int col1 = block * SUBGRID_SIZE + rand() % SUBGRID_SIZE;
-    int col2 = block * SUBGRID_SIZE + rand() % SUBGRID_SIZE;
+template <int BOX>
+void BasicSudokuBoard<BOX>::swapColsInBlock() {
+    Xoshiro256& rng = localGenerator<BOX>().random();
+    int block = rng.below(SUBGRID_SIZE);
+    int col1 = block * SUBGRID_SIZE + rng.below(SUBGRID_SIZE);
+    int col2 = block * SUBGRID_SIZE + rng.below(SUBGRID_SIZE);
     if(col1 != col2) {
-        for(int i = 0; i < SIZE; i++) {
-            swap(board[i][col1], board[i][col2]);
-        }
+        swapCols(col1, col2);
     }
-    initializeBitsets();
 }
 
 // Swaps entire row blocks to create a new variation of the grid.
-void SudokuBoard::swapRowBlocks() {
-    int block1 = rand() % SUBGRID_SIZE;
-    int block2 = rand() % SUBGRID_SIZE;
+template <int BOX>
+void BasicSudokuBoard<BOX>::swapRowBlocks() {
+    Xoshiro256& rng = localGenerator<BOX>().random();
+    int block1 = rng.below(SUBGRID_SIZE);
+    int block2 = rng.below(SUBGRID_SIZE);
     if (block1 != block2) {
         for (int i = 0; i < SUBGRID_SIZE; i++) {
-            swap(board[block1 * SUBGRID_SIZE + i], board[block2 * SUBGRID_SIZE + i]);
+            swapRows(block1 * SUBGRID_SIZE + i, block2 * SUBGRID_SIZE + i);
+            swap(boxUsed[block1 * SUBGRID_SIZE + i], boxUsed[block2 * SUBGRID_SIZE + i]);
         }
     }
 }
 
 // Swaps entire column blocks to create a new variation of the grid.
-void SudokuBoard::swapColBlocks() {
-    int block1 = rand() % SUBGRID_SIZE;
-    int block2 = rand() % SUBGRID_SIZE;
+template <int BOX>
+void BasicSudokuBoard<BOX>::swapColBlocks() {
+    Xoshiro256& rng = localGenerator<BOX>().random();
+    int block1 = rng.below(SUBGRID_SIZE);
+    int block2 = rng.below(SUBGRID_SIZE);
     if (block1 != block2) {
-        for (int i = 0; i < SIZE; i++) {
-            for (int j = 0; j < SUBGRID_SIZE; j++) {
-                swap(board[i][block1 * SUBGRID_SIZE + j], board[i][block2 * SUBGRID_SIZE + j]);
-            }
+        for (int j = 0; j < SUBGRID_SIZE; j++) {
+            swapCols(block1 * SUBGRID_SIZE + j, block2 * SUBGRID_SIZE + j);
+            swap(boxUsed[j * SUBGRID_SIZE + block1], boxUsed[j * SUBGRID_SIZE + block2]);
         }
     }
 }
 
 // Randomizes the grid by performing a series of transformations.
-void SudokuBoard::randomizeGrid() {
-    int numShuffles = 10 + rand() % 10;
+template <int BOX>
+void BasicSudokuBoard<BOX>::randomizeGrid() {
+    Xoshiro256& rng = localGenerator<BOX>().random();
+    int numShuffles = 10 + rng.below(10);
     for(int i = 0; i < numShuffles; i++) {
-        switch(rand() % 5) {
+        switch(rng.below(5)) {
             case 0: transpose(); break;
             case 1: swapRowsInBlock(); break;
             case 2: swapColsInBlock(); break;
@@ -129,11 +218,22 @@ void SudokuBoard::randomizeGrid() {
     }
 }
 
-// Removes numbers from the grid to create the puzzle, ensuring they can be re-added by the player.
-void SudokuBoard::removeNumbers(int numToRemove) {
+// Removes numbers from the grid to create the puzzle, keeping only removals that leave a unique solution.
+template <int BOX>
+void BasicSudokuBoard<BOX>::removeNumbers(int numToRemove) {
+    removeNumbers([numToRemove](const Grid&, int removed) {
+        return removed < numToRemove ? Dig::KEEP : Dig::STOP;
+    });
+}
+
+// Blanks cells in random order. A removal that leaves a unique solution is then put to
+// `filter`, which sees the puzzle with the new hole and the number of holes so far.
+template <int BOX>
+void BasicSudokuBoard<BOX>::removeNumbers(const DigFilter& filter) {
     solution = board; // Store the solution for validation.
+    recountCells();
     vector<pair<int, int>> positions;
-    isEditable = vector<vector<bool>>(SIZE, vector<bool>(SIZE, false));
+    givens.set(); // Every cell starts as a given.
     
     // Collect all positions on the board.
     for(int i = 0; i < SIZE; i++) {
@@ -142,86 +242,160 @@ void SudokuBoard::removeNumbers(int numToRemove) {
         }
     }
     
-    random_device rd;
-    mt19937 gen(rd());
-    shuffle(positions.begin(), positions.end(), gen); // Randomize positions.
-    
-    for(int i = 0; i < numToRemove && i < positions.size(); i++) {
+    shuffle(positions.begin(), positions.end(), localGenerator<BOX>().random()); // Randomize positions.
+
+    BasicSolver<BOX> solver;
+    Grid grid = board;
+
+    int removed = 0;
+    for(size_t i = 0; i < positions.size(); i++) {
         int row = positions[i].first;
         int col = positions[i].second;
-        board[row][col] = 0; // Clear the cell.
-        isEditable[row][col] = true; // Mark it as editable.
-        updateBitsets(row, col, solution[row][col], false);
+        int cell = cellIndex(row, col);
+
+        // Blank the cell tentatively and keep it blank only if the puzzle stays unique.
+        grid[cell] = 0;
+        if (solver.countSolutions(grid, 2) != 1) {
+            grid[cell] = solution[cell];
+            continue;
+        }
+
+        Dig verdict = filter(grid, removed + 1);
+        if (verdict == Dig::UNDO) {
+            grid[cell] = solution[cell];
+            continue;
+        }
+
+        setCell(cell, 0); // Clear the cell.
+        givens.reset(cell); // Mark it as editable.
+        updateBitsets(row, col, solution[cell], false);
+        removed++;
+        if (verdict == Dig::STOP) break;
     }
 }
 
+// Replaces the whole board with saved state, checking it in the same pass that rebuilds the
+// masks: the solution must be a complete valid grid, every given must match it and the placed
+// numbers must not conflict. Throws invalid_argument and leaves the board unchanged otherwise.
+template <int BOX>
+void BasicSudokuBoard<BOX>::load(const Grid& cells, const Grid& answer, const bitset<CELLS>& given) {
+    const auto& tables = gridTables<BOX>;
+    array<Mask, SIZE> rows{}, cols{}, boxes{};
+    array<Mask, SIZE> solutionRows{}, solutionCols{}, solutionBoxes{};
+
+    for (int cell = 0; cell < CELLS; cell++) {
+        int num = cells[cell];
+        int answerNum = answer[cell];
+        if (num > SIZE || answerNum < 1 || answerNum > SIZE) {
+            throw invalid_argument("Saved board has values out of range");
+        }
+        int row = tables.rowOf[cell], col = tables.colOf[cell], box = tables.boxOf[cell];
+
+        Mask answerBit = Mask(1) << (answerNum - 1);
+        if ((solutionRows[row] | solutionCols[col] | solutionBoxes[box]) & answerBit) {
+            throw invalid_argument("Saved solution is not a valid grid");
+        }
+        solutionRows[row] |= answerBit;
+        solutionCols[col] |= answerBit;
+        solutionBoxes[box] |= answerBit;
+
+        if (given[cell] && num != answerNum) {
+            throw invalid_argument("Saved givens do not match the solution");
+        }
+        if (num == 0) continue;
+        Mask bit = Mask(1) << (num - 1);
+        if ((rows[row] | cols[col] | boxes[box]) & bit) {
+            throw invalid_argument("Saved board has conflicting numbers");
+        }
+        rows[row] |= bit;
+        cols[col] |= bit;
+        boxes[box] |= bit;
+    }
+
+    board = cells;
+    solution = answer;
+    givens = given;
+    rowUsed = rows;
+    colUsed = cols;
+    boxUsed = boxes;
+    recountCells();
+}
+
 // Checks if a move is valid (i.e., does not conflict with existing numbers).
-bool SudokuBoard::isValidMove(int row, int col, int num) const {
-    return !rowUsed[row][num-1] && 
-           !colUsed[col][num-1] && 
-           !boxUsed[(row/3)*3 + col/3][num-1];
+template <int BOX>
+bool BasicSudokuBoard<BOX>::isValidMove(int row, int col, int num) const {
+    Mask bit = Mask(1) << (num - 1);
+    return !((rowUsed[row] | colUsed[col] | boxUsed[boxIndex(row, col)]) & bit);
+}
+
+// Returns the digits an empty cell can still take (0 for a filled cell).
+template <int BOX>
+typename BasicSudokuBoard<BOX>::Mask BasicSudokuBoard<BOX>::getCandidates(int row, int col) const {
+    if (board[cellIndex(row, col)] != 0) return 0;
+    return static_cast<Mask>(Traits::ALL_DIGITS & ~(rowUsed[row] | colUsed[col] | boxUsed[boxIndex(row, col)]));
 }
 
 // Makes a move by placing a number on the board if it's valid.
-void SudokuBoard::makeMove(int row, int col, int num) {
-    if (row < 0 || row >= SIZE || col < 0 || col >= SIZE || num < 1 || num > 9) {
+template <int BOX>
+void BasicSudokuBoard<BOX>::makeMove(int row, int col, int num) {
+    if (row < 0 || row >= SIZE || col < 0 || col >= SIZE || num < 1 || num > SIZE) {
         throw invalid_argument("Invalid input values");
     }
 
-    if (!isEditable[row][col]) {
+    int cell = cellIndex(row, col);
+    if (givens[cell]) {
         throw invalid_argument("This cell cannot be changed");
     }
 
     // If the cell already contains a value, remove it before placing the new one.
-    if (board[row][col] != 0) {
-        updateBitsets(row, col, board[row][col], false);
+    if (board[cell] != 0) {
+        updateBitsets(row, col, board[cell], false);
     }
 
     if (!isValidMove(row, col, num)) {
         // Revert the previous value if the new one is invalid.
-        if (board[row][col] != 0) {
-            updateBitsets(row, col, board[row][col], true);
+        if (board[cell] != 0) {
+            updateBitsets(row, col, board[cell], true);
         }
         throw invalid_argument("Invalid move: number conflicts with row, column, or block");
     }
 
-    board[row][col] = num;
+    setCell(cell, num);
     updateBitsets(row, col, num, true);
 }
 
 // Deletes a number from the board, making the cell empty.
-void SudokuBoard::deleteMove(int row, int col) {
+template <int BOX>
+void BasicSudokuBoard<BOX>::deleteMove(int row, int col) {
     if (row < 0 || row >= SIZE || col < 0 || col >= SIZE) {
         throw invalid_argument("Invalid input values");
     }
 
-    if (!isEditable[row][col]) {
+    int cell = cellIndex(row, col);
+    if (givens[cell]) {
         throw invalid_argument("This cell cannot be changed");
     }
 
-    if (board[row][col] == 0) {
+    if (board[cell] == 0) {
         throw invalid_argument("Cell is already empty");
     }
 
-    updateBitsets(row, col, board[row][col], false);
-    board[row][col] = 0; // Clear the cell.
+    updateBitsets(row, col, board[cell], false);
+    setCell(cell, 0); // Clear the cell.
 }
 
 // Checks if the board is solved by comparing it with the solution.
-bool SudokuBoard::isSolved() const {
-    for(int i = 0; i < SIZE; i++) {
-        for(int j = 0; j < SIZE; j++) {
-            if(board[i][j] != solution[i][j]) return false;
-        }
-    }
-    return true;
+template <int BOX>
+bool BasicSudokuBoard<BOX>::isSolved() const {
+    return mismatchCount == 0;
 }
 
 // Provides a hint by identifying the first empty cell and its solution.
-pair<int, int> SudokuBoard::getHint() const {
+template <int BOX>
+pair<int, int> BasicSudokuBoard<BOX>::getHint() const {
     for(int i = 0; i < SIZE; i++) {
         for(int j = 0; j < SIZE; j++) {
-            if(board[i][j] == 0) {
+            if(board[cellIndex(i, j)] == 0) {
                 return {i, j};
             }
         }
@@ -230,83 +404,123 @@ pair<int, int> SudokuBoard::getHint() const {
 }
 
 // Retrieves the solution value for a specific cell.
-int SudokuBoard::getSolutionValue(int row, int col) const {
-    return solution[row][col];
+template <int BOX>
+int BasicSudokuBoard<BOX>::getSolutionValue(int row, int col) const {
+    return solution[cellIndex(row, col)];
+}
+
+// Retrieves the current value of a cell (0 if empty).
+template <int BOX>
+int BasicSudokuBoard<BOX>::getValue(int row, int col) const {
+    return board[cellIndex(row, col)];
+}
+
+// Checks whether a cell is part of the original puzzle.
+template <int BOX>
+bool BasicSudokuBoard<BOX>::isGiven(int row, int col) const {
+    return givens[cellIndex(row, col)];
+}
+
+// The cells in row-major order (0 for empty), for packing the board.
+template <int BOX>
+const typename BasicSudokuBoard<BOX>::Grid& BasicSudokuBoard<BOX>::getCells() const {
+    return board;
+}
+
+template <int BOX>
+const typename BasicSudokuBoard<BOX>::Grid& BasicSudokuBoard<BOX>::getSolution() const {
+    return solution;
+}
+
+template <int BOX>
+const bitset<BasicSudokuBoard<BOX>::CELLS>& BasicSudokuBoard<BOX>::getGivens() const {
+    return givens;
 }
 
 // Checks if the board is fully filled.
-bool SudokuBoard::isBoardFull() const {
-    for(int i = 0; i < SIZE; i++) {
-        for(int j = 0; j < SIZE; j++) {
-            if(board[i][j] == 0) return false;
-        }
-    }
-    return true;
+template <int BOX>
+bool BasicSudokuBoard<BOX>::isBoardFull() const {
+    return filledCount == CELLS;
 }
 
-// Compares the current board with the solution to identify errors.
-vector<vector<bool>> SudokuBoard::checkBoard() const {
-    vector<vector<bool>> errors(SIZE, vector<bool>(SIZE, false));
-    
-    if (isBoardFull()) {
-        for (int i = 0; i < SIZE; i++) {
-            for (int j = 0; j < SIZE; j++) {
-                if (isEditable[i][j] && board[i][j] != solution[i][j]) {
-                    errors[i][j] = true;
-                }
-            }
-        }
-    }
-    return errors;
+// Checks whether a filled cell differs from the solution.
+template <int BOX>
+bool BasicSudokuBoard<BOX>::isWrong(int row, int col) const {
+    return wrongCells[cellIndex(row, col)];
+}
+
+// Returns the wrong cells as a bitmask in row-major order.
+template <int BOX>
+const bitset<BasicSudokuBoard<BOX>::CELLS>& BasicSudokuBoard<BOX>::getWrongCells() const {
+    return wrongCells;
+}
+
+// Returns the number of non-empty cells.
+template <int BOX>
+int BasicSudokuBoard<BOX>::getFilledCount() const {
+    return filledCount;
+}
+
+// Returns the number of filled cells that differ from the solution.
+template <int BOX>
+int BasicSudokuBoard<BOX>::getWrongCount() const {
+    return static_cast<int>(wrongCells.count());
 }
 
 // Displays the Sudoku board in a formatted and color-coded way.
-void SudokuBoard::printBoard() const {
-    const string RESET_COLOR = "\033[0m";
-    const string BLUE_COLOR = "\033[96m";
-    const string WHITE_COLOR = "\033[37m";
-    const string RED_COLOR = "\033[31m";
+template <int BOX>
+void BasicSudokuBoard<BOX>::printBoard(ostream& out) const {
+    const char* const RESET_COLOR = "\033[0m";
+    const char* const BLUE_COLOR = "\033[96m";
+    const char* const WHITE_COLOR = "\033[37m";
+    const char* const RED_COLOR = "\033[31m";
+
+    bool showErrors = isBoardFull(); // Wrong entries are only marked once the board is full.
 
-    vector<vector<bool>> errors = checkBoard();
-    bool showErrors = isBoardFull();
+    const int width = SIZE > 9 ? 2 : 1; // Characters per cell value.
+    const int lineLength = SIZE * (width + 1) + 3;
 
-    cout << "\n   ";
+    out << "\n" << string(width + 2, ' ');
     for (int j = 0; j < SIZE; j++) {
-        cout << j + 1 << " ";
-        if ((j + 1) % SUBGRID_SIZE == 0 && j != SIZE - 1) cout << "  ";
+        out << setw(width) << j + 1 << " ";
+        if ((j + 1) % SUBGRID_SIZE == 0 && j != SIZE - 1) out << "  ";
     }
-    cout << "\n   ";
-    for (int j = 0; j < SIZE * 2 + 3; j++) cout << "-";
-    cout << "\n";
+    out << "\n" << string(width + 2, ' ') << string(lineLength, '-') << "\n";
 
     for (int i = 0; i < SIZE; i++) {
-        cout << i + 1 << "| ";
+        out << setw(width) << i + 1 << "| ";
         for (int j = 0; j < SIZE; j++) {
-            if (board[i][j] == 0) {
-                cout << "_ ";
+            int cell = cellIndex(i, j);
+            if (board[cell] == 0) {
+                out << string(width - 1, ' ') << "_ ";
             } else {
-                if (isEditable[i][j]) {
-                    if (errors[i][j]) {
-                        cout << RED_COLOR;
+                if (!givens[cell]) {
+                    if (showErrors && wrongCells[cell]) {
+                        out << RED_COLOR;
                     } else {
-                        cout << BLUE_COLOR;
+                        out << BLUE_COLOR;
                     }
                 } else {
-                    cout << WHITE_COLOR;
+                    out << WHITE_COLOR;
                 }
 
-                cout << board[i][j] << RESET_COLOR << " ";
+                out << setw(width) << int(board[cell]) << RESET_COLOR << " ";
             }
-            if ((j + 1) % SUBGRID_SIZE == 0 && j != SIZE - 1) cout << "| ";
+            if ((j + 1) % SUBGRID_SIZE == 0 && j != SIZE - 1) out << "| ";
         }
-        cout << "|\n";
+        out << "|\n";
         if ((i + 1) % SUBGRID_SIZE == 0 && i != SIZE - 1) {
-            cout << "   ";
-            for (int j = 0; j < SIZE * 2 + 3; j++) cout << "-";
-            cout << "\n";
+            out << string(width + 2, ' ') << string(lineLength, '-') << "\n";
         }
     }
-    cout << "   ";
-    for (int j = 0; j < SIZE * 2 + 3; j++) cout << "-";
-    cout << "\n";
+    out << string(width + 2, ' ') << string(lineLength, '-') << "\n";
 }
+
+template class BasicSudokuBoard<3>;
+template class BasicSudokuBoard<4>;
+template class BasicSudokuBoard<5>;
+
+static_assert(sizeof(BasicSudokuBoard<3>) <= 264, "9x9 SudokuBoard grew past its flat layout");
+static_assert(is_trivially_copyable<BasicSudokuBoard<3>>::value, "SudokuBoard must stay a flat, memcpy-able block");
+static_assert(is_trivially_copyable<BasicSudokuBoard<4>>::value, "SudokuBoard must stay a flat, memcpy-able block");
+static_assert(is_trivially_copyable<BasicSudokuBoard<5>>::value, "SudokuBoard must stay a flat, memcpy-able block");
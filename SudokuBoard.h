@@ -1,29 +1,61 @@
 #ifndef SUDOKU_BOARD_H
 #define SUDOKU_BOARD_H
 
-#include <vector>
+#include "GridTraits.h"
+#include <array>
 #include <bitset>
+#include <cstdint>
+#include <functional>
+#include <iostream>
+#include <vector>
 #include <utility>
 using namespace std;
 
-class SudokuBoard {
+// The whole board is one flat, trivially copyable block (264 bytes for 9x9),
+// so copying or snapshotting a board is a plain memcpy. Filled, mismatched and wrong
+// cells are tracked as moves are made, so the solved/full/error queries are O(1).
+// BOX is the box width: 3 for the classic 9x9 board, 4 for 16x16, 5 for 25x25.
+template <int BOX>
+class BasicSudokuBoard {
+public:
+    using Traits = GridTraits<BOX>;
+    static constexpr int SIZE = Traits::SIZE;
+    static constexpr int SUBGRID_SIZE = Traits::SUBGRID_SIZE;
+    static constexpr int CELLS = Traits::CELLS;
+
+    using Grid = typename Traits::Grid;
+    using Mask = typename Traits::Mask;
+
+    // Verdict on a tentative hole while digging a puzzle: keep it, put the digit back,
+    // or keep it and stop digging.
+    enum class Dig { KEEP, UNDO, STOP };
+    using DigFilter = function<Dig(const Grid& puzzle, int removed)>;
+
 private:
-    static const int SIZE = 9;
-    static const int SUBGRID_SIZE = 3;
-    
-    vector<vector<int>> board;
-    vector<vector<int>> solution;
-    vector<vector<bool>> isEditable;
-    vector<bitset<9>> rowUsed;
-    vector<bitset<9>> colUsed;
-    vector<bitset<9>> boxUsed;
+    Grid board;
+    Grid solution;
+    bitset<CELLS> givens;
+    array<Mask, SIZE> rowUsed;
+    array<Mask, SIZE> colUsed;
+    array<Mask, SIZE> boxUsed;
+    bitset<CELLS> wrongCells;   // Filled cells whose value differs from the solution.
+    int filledCount;
+    int mismatchCount;          // Cells (empty or not) that differ from the solution.
+
+    static int cellIndex(int row, int col) { return row * SIZE + col; }
+    static int boxIndex(int row, int col) { return Traits::boxOf(row, col); }
 
     void updateBitsets(int row, int col, int num, bool setValue);
     void initializeBitsets();
+    void setCell(int cell, int num);
+    void recountCells();
+    void swapCells(int cell1, int cell2);
+    void swapRows(int row1, int row2);
+    void swapCols(int col1, int col2);
 
 public:
-    SudokuBoard();
-    vector<vector<bool>> checkBoard() const;
+    BasicSudokuBoard();
+    void generateRandomGrid();
     void generateBaseGrid();
     void transpose();
     void swapRowsInBlock();
@@ -32,17 +64,28 @@ public:
     void swapColBlocks();
     void randomizeGrid();
     void removeNumbers(int numToRemove);
+    void removeNumbers(const DigFilter& filter);
+    void load(const Grid& cells, const Grid& answer, const bitset<CELLS>& given);
     void deleteMove(int row, int col);
     bool isValidMove(int row, int col, int num) const;
+    Mask getCandidates(int row, int col) const;
     void makeMove(int row, int col, int num);
     bool isSolved() const;
     bool isBoardFull() const;
+    bool isWrong(int row, int col) const;
+    const bitset<CELLS>& getWrongCells() const;
+    int getFilledCount() const;
+    int getWrongCount() const;
     pair<int, int> getHint() const;
     int getSolutionValue(int row, int col) const;
-    void printBoard() const;
-
-    
+    int getValue(int row, int col) const;
+    bool isGiven(int row, int col) const;
+    const Grid& getCells() const;
+    const Grid& getSolution() const;
+    const bitset<CELLS>& getGivens() const;
+    void printBoard(ostream& out = cout) const;
 };
 
-#endif
+using SudokuBoard = BasicSudokuBoard<3>;
 
+#endif
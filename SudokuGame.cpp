@@ -1,39 +1,38 @@
-#include "SudokuGame.h"
+﻿#include "SudokuGame.h"
 #include <iostream>
 #include <limits>
 #include <cstdlib>
 #include <thread>
 #include <iomanip>
+#include <sstream>
+#include <stdexcept>
+#include <filesystem>
+#include <algorithm>
+#include <chrono>
+#include <cctype>
+#include <cstring>
 using namespace std;
 
-// Constructor: Initializes the game, sets default values for leaderboard, difficulty, and score.
+// Constructor: Initializes the game; the session records finished games on the leaderboard.
 SudokuGame::SudokuGame() 
-    : leaderboard("leaderboard.txt"), 
-    difficulty(0), 
-    score(0),
-    elapsedSeconds(0),
-    timerRunning(false) {}
+    : leaderboard(LEADERBOARD_FILE), 
+    session(puzzlePool, &leaderboard) {
+    solutions.load(SOLUTION_CACHE_FILE);
+}
 
-// Clears the screen based on the operating system.
-void SudokuGame::clearScreen() {
-    #ifdef _WIN32
-        system("cls");
-    #else
-        system("clear");
-    #endif
+// Destructor: Keeps the puzzles solved this run for the next one.
+SudokuGame::~SudokuGame() {
+    if (solutions.stats().misses > 0) solutions.save(SOLUTION_CACHE_FILE);
 }
 
-void SudokuGame::startTimer() {
-    startTime = system_clock::now();
-    timerRunning = true;
-    elapsedSeconds = 0;
+// Records the player's games in `journal` (see MoveJournal).
+void SudokuGame::setJournal(MoveJournal* journal) {
+    session.setJournal(journal);
 }
 
-void SudokuGame::updateTimer() {
-    if (timerRunning) {
-        auto currentTime = system_clock::now();
-        elapsedSeconds = duration_cast<seconds>(currentTime - startTime).count();
-    }
+// Clears the screen with an escape sequence instead of running a shell command.
+void SudokuGame::clearScreen() {
+    renderer.clear();
 }
 
 string SudokuGame::formatTime(int seconds) {
@@ -57,52 +56,186 @@ void SudokuGame::handleSolvePuzzle() {
     solver.printBoard(customBoard);
     
     cout << "\nTrying to solve the puzzle...\n";
-    if(solver.solve(customBoard)) {
+    SolutionCache::Grid grid;
+    for (int i = 0; i < InstrumentedSolver::SIZE; i++)
+        for (int j = 0; j < InstrumentedSolver::SIZE; j++)
+            grid[i * InstrumentedSolver::SIZE + j] = static_cast<uint8_t>(customBoard[i][j]);
+
+    // A puzzle entered before is answered from the cache without searching again.
+    bool cached = false;
+    if(solutions.solve(grid, solver, &cached)) {
+        for (int i = 0; i < InstrumentedSolver::SIZE; i++)
+            for (int j = 0; j < InstrumentedSolver::SIZE; j++)
+                customBoard[i][j] = grid[i * InstrumentedSolver::SIZE + j];
         cout << "\nSolution found!\n";
         solver.printBoard(customBoard);
     } else {
         cout << "\nNo solution exists for this puzzle!\n";
     }
+    if (cached) {
+        cout << "(answered from the solution cache)\n";
+    } else {
+        solver.getStats()->print(cout);
+    }
 }
 
-// Prompts the user for a valid integer input within a specified range.
-int SudokuGame::getValidInput(const string& prompt, int min, int max) {
-    int value;
+// Each player has one save slot, named after the nickname. Nicknames may hold any
+// non-blank character, so everything but lowercase letters, digits, '-' and '_' is written
+// as %XX; that keeps separators, ".." and drive letters out of the path, and keeps "Alice"
+// and "alice" apart on case-insensitive file systems. A name that Windows reserves for a
+// device (con, nul, com1...) gets its first letter encoded as well.
+string SudokuGame::savePath(const string& playerName) {
+    static const char* const DEVICES[] = {"CON", "PRN", "AUX", "NUL", "COM", "LPT"};
+    string upper;
+    for (char c : playerName) upper += static_cast<char>(toupper(static_cast<unsigned char>(c)));
+    bool device = false;
+    for (const char* name : DEVICES) {
+        size_t length = strlen(name);
+        if (upper.compare(0, length, name) == 0 &&
+            (upper.size() == length || (upper.size() == length + 1 && isdigit(static_cast<unsigned char>(upper.back()))))) {
+            device = true;
+        }
+    }
+
+    static const char HEX[] = "0123456789ABCDEF";
+    string file;
+    for (size_t i = 0; i < playerName.size(); i++) {
+        unsigned char c = static_cast<unsigned char>(playerName[i]);
+        if ((islower(c) || isdigit(c) || c == '-' || c == '_') && !(device && i == 0)) {
+            file += static_cast<char>(c);
+        } else {
+            file += '%';
+            file += HEX[c >> 4];
+            file += HEX[c & 0xF];
+        }
+    }
+    return string(SAVE_DIR) + "/" + file + ".sav";
+}
+
+// Saves the game in progress so the player can pick it up next time.
+void SudokuGame::saveGame() {
+    if (!session.isActive()) return;
+    error_code ignored;
+    filesystem::create_directories(SAVE_DIR, ignored);
+    if (GameSnapshot::writeFile(savePath(session.getPlayerName()), session.save())) {
+        cout << "Game saved. Enter the same nickname to resume it.\n";
+    } else {
+        cout << "Could not save the game!\n";
+    }
+}
+
+// Offers the player's saved game, if there is one. The save is used up once resumed.
+bool SudokuGame::offerResume(const string& playerName) {
+    string path = savePath(playerName);
+    GameSnapshot snapshot;
+    if (!GameSnapshot::readFile(path, snapshot)) return false;
+
+    cout << "You have a saved game (" << formatTime(static_cast<int>(snapshot.seconds)) << " played, "
+         << snapshot.score << " points).\n";
+    if (getValidInput("Resume it? (1 - yes, 2 - no): ", 1, 2) != 1) return false;
+
+    GameResult resumed = session.resume(playerName, snapshot);
+    if (!resumed.ok) {
+        cout << "Could not resume the saved game: " << resumed.error << "\n";
+        return false;
+    }
+    error_code ignored;
+    filesystem::remove(path, ignored);
+    return true;
+}
+
+// Reads one line. During a game on a terminal the screen stays live (see readLiveLine);
+// otherwise `screen` is drawn, the prompt printed and a line read as usual.
+// Returns false at the end of input.
+bool SudokuGame::readLine(const string& screen, const string& prompt, string& line) {
+    if (input.isInteractive() && session.isActive() && screen.rfind(CLOCK_LABEL, 0) == 0 &&
+        cin.rdbuf()->in_avail() <= 0) {
+        return readLiveLine(screen, prompt, line);
+    }
+    if (!screen.empty()) renderer.present(screen);
+    cout << prompt;
+    return static_cast<bool>(getline(cin, line));
+}
+
+// Shows the screen and prompt in raw mode until Enter. Keys are echoed as they arrive,
+// and once per second of game time only the clock at the top is rewritten. In between
+// the thread sleeps in poll(), waking for the next key or the next tick.
+bool SudokuGame::readLiveLine(const string& screen, const string& prompt, string& line) {
+    TerminalInput::RawMode raw(input);
+    const string label = CLOCK_LABEL;
+    const int clockRow = static_cast<int>(count(label.begin(), label.end(), '\n'));
+    const int clockCol = static_cast<int>(label.size() - label.rfind('\n') - 1);
+    string shown = screen; // The screen with the clock as last drawn.
+
+    line.clear();
+    renderer.present(shown + prompt);
+    TickScheduler clock(session.getStartTime(), chrono::seconds(1));
     while (true) {
-        cout << prompt;
-        if (!(cin >> value)) {
-            cin.clear();
-            cin.ignore(numeric_limits<streamsize>::max(), '\n');
-            cout << "Invalid input! Please enter a number.\n";
+        int key = input.readKey(clock.millisUntilDue());
+        if (clock.due()) {
+            string time = formatTime(session.elapsedSeconds());
+            shown.replace(label.size(), shown.find('\n', label.size()) - label.size(), time);
+            // The clock row is counted from the top of the frame, which is only where
+            // patch() expects it while the frame fits the window; otherwise redraw.
+            if (!renderer.patch(clockRow, clockCol, time)) renderer.present(shown + prompt + line);
+        }
+
+        if (key == TerminalInput::NONE) continue;
+        if (key == TerminalInput::END) {
+            if (line.empty()) return false;
+            key = '\n';
+        }
+        if (key == '\r' || key == '\n') {
+            renderer.present(shown + prompt + line + "\n");
+            return true;
+        }
+        if (key == 127 || key == '\b') {
+            if (!line.empty()) line.pop_back();
+        } else if (key == 21) { // Ctrl-U
+            line.clear();
+        } else if (key >= ' ' && key < 127 && line.size() < MAX_LINE) {
+            line += static_cast<char>(key);
+        } else {
             continue;
         }
-        if (value >= min && value <= max) {
-            cin.ignore(numeric_limits<streamsize>::max(), '\n');
-            return value;
+        renderer.present(shown + prompt + line);
+    }
+}
+
+// Prompts the user for a valid integer input within a specified range.
+int SudokuGame::getValidInput(const string& prompt, int min, int max, const string& screen) {
+    string message;
+    while (true) {
+        string line;
+        if (!readLine(screen, message + prompt, line)) throw runtime_error("End of input");
+        istringstream in(line);
+        int value;
+        if (!(in >> value)) {
+            message = "Invalid input! Please enter a number.\n";
+            continue;
         }
-        cout << "Number must be between " << min << " and " << max << "!\n";
+        if (value >= min && value <= max) return value;
+        message = "Number must be between " + to_string(min) + " and " + to_string(max) + "!\n";
     }
 }
 
 // Starts a new game by setting up the board and difficulty level.
 void SudokuGame::start() {
-    srand(time(0)); // Seed for random number generation.
+    puzzlePool.start(); // Start pre-generating puzzles in the background.
     clearScreen();
 
-    startTime = system_clock::now();
-    timerRunning = true;
-
     while (true) {
-        clearScreen();
-        cout << "\t\t\t<================================================================================>" << endl;
-        cout << "\t\t\t|                        Welcome, dear user!                                     |" << endl;
-        cout << "\t\t\t|                    Choose an action to proceed                                 |" << endl;
-        cout << "\t\t\t<================================================================================>" << endl;
-
-        cout<< "[1] - Play a new game\n";
-        cout<< "[2] - Sudoku solver\n";
-        cout<< "[3] - Leaderboard\n";
-        cout<< "[4] - Exit\n";
+        ostringstream frame;
+        frame << "\t\t\t<================================================================================>" << endl;
+        frame << "\t\t\t|                        Welcome, dear user!                                     |" << endl;
+        frame << "\t\t\t|                    Choose an action to proceed                                 |" << endl;
+        frame << "\t\t\t<================================================================================>" << endl;
+
+        frame << "[1] - Play a new game\n";
+        frame << "[2] - Sudoku solver\n";
+        frame << "[3] - Leaderboard\n";
+        frame << "[4] - Exit\n";
+        renderer.present(frame.str());
 
         int choice = getValidInput("Your choice: ", 1, 4);
 
@@ -116,12 +249,20 @@ void SudokuGame::start() {
                 cout << "\t\t\t<================================================================================>" << endl;
 
                 // Prompt the user for their nickname.
+                string playerName;
                 do {
-                    cout << "ENTER YOUR NICKNAME (3-20 chars): ";
-                    getline(cin, playerName);
-                } while (playerName.length() < 3 || playerName.length() > 20);
+                    if (!readLine("", "ENTER YOUR NICKNAME (3-20 chars): ", playerName)) {
+                        throw runtime_error("End of input");
+                    }
+                } while (!GameSession::isValidName(playerName));
+
+                if (offerResume(playerName)) {
+                    playGame();
+                    break;
+                }
 
                 // Select the difficulty level.
+                int difficulty;
                 while (true) {
                     cout << "Choose difficulty level:\n";
                     cout << "1. Very Easy\n";
@@ -132,23 +273,8 @@ void SudokuGame::start() {
                     break;
                 }
 
-                // Initialize the board and adjust the number of cells to remove based on difficulty.
-                board = SudokuBoard();
-                board.generateBaseGrid();
-                board.randomizeGrid();
-
-                int numToRemove;
-                switch (difficulty) {
-                    case 1: numToRemove = 4; break;
-                    case 2: numToRemove = 40; break;
-                    case 3: numToRemove = 50; break;
-                    case 4: numToRemove = 60; break;
-                }
-
-                score = difficulty * 100; // Base score based on difficulty.
-                board.removeNumbers(numToRemove); // Remove numbers to create the puzzle.
-
-                startTimer();
+                // Take a pre-generated puzzle (generated on the spot if none is ready).
+                session.newGame(playerName, difficulty);
                 playGame();
                 break;
             }
@@ -175,136 +301,133 @@ void SudokuGame::start() {
     }
 }
 
-// Main game loop for playing the Sudoku game.
-void SudokuGame::playGame() {
-    while (true) {
-        clearScreen();
-        updateTimer();
-
-        if (timerRunning) {
-            cout << "\nTime: " << formatTime(elapsedSeconds) << "\n";
-        }
-
-        board.printBoard();
+// The game screen: the clock, the board and the actions.
+string SudokuGame::gameScreen() {
+    ostringstream frame;
+    if (session.isActive()) {
+        frame << CLOCK_LABEL << formatTime(session.elapsedSeconds()) << "\n";
+    }
 
-        // Display available actions.
-        cout << "\nChoose action:\n";
-        cout << "[1] - Make a move\n";
-        cout << "[2] - Get a hint\n";
-        cout << "[3] - Main menu\n";
-        cout << "[4] - Delete a cell\n";
-        cout << "[5] - Leaderboard\n";
-        cout << "[6] - Exit\n";
+    session.getBoard().printBoard(frame);
+
+    // Display available actions.
+    frame << "\nChoose action:\n";
+    frame << "[1] - Make a move\n";
+    frame << "[2] - Get a hint\n";
+    frame << "[3] - Main menu\n";
+    frame << "[4] - Delete a cell\n";
+    frame << "[5] - Leaderboard\n";
+    frame << "[6] - Exit\n";
+    return frame.str();
+}
 
-        int choice = getValidInput("Your choice: ", 1, 7);
+// Main game loop for playing the Sudoku game. Messages go under the actions on the next
+// screen, so the live screen never has to make room for stray output.
+void SudokuGame::playGame() {
+    string status;
+    while (true) {
+        // Build the whole screen, then let the renderer send only what changed.
+        string screen = gameScreen() + status;
+        status.clear();
+        int choice = getValidInput("Your choice: ", 1, 7, screen);
 
         try {
             switch (choice) {
                 case 1: { // Make a move.
-                    int row, col, num;
+                    string message;
+                    GameResult moved;
+                    moved.ok = false;
                     while (true) {
-                        cout << "Enter row (1-9), column (1-9), and number (1-9): ";
-                        if (!(cin >> row >> col >> num)) {
-                            cin.clear();
-                            cin.ignore(numeric_limits<streamsize>::max(), '\n');
-                            cout << "Invalid input! Please enter three numbers.\n";
+                        string line;
+                        if (!readLine(screen, message + "Enter row (1-9), column (1-9), and number (1-9): ", line)) break;
+                        istringstream in(line);
+                        int row, col, num;
+                        if (!(in >> row >> col >> num)) {
+                            message = "Invalid input! Please enter three numbers.\n";
                             continue;
                         }
 
                         if (row < 1 || row > 9 || col < 1 || col > 9 || num < 1 || num > 9) {
-                            cin.ignore(numeric_limits<streamsize>::max(), '\n');
-                            cout << "Numbers must be between 1 and 9!\n";
+                            message = "Numbers must be between 1 and 9!\n";
                             continue;
                         }
 
-                        try {
-                            board.makeMove(row - 1, col - 1, num);
-                            break; // Exit the loop on successful move.
-                        } catch (const exception& e) {
-                            cin.ignore(numeric_limits<streamsize>::max(), '\n');
-                            cout << "Error: " << e.what() << "\n";
-                            continue;
-                        }
+                        moved = session.move(row - 1, col - 1, num);
+                        if (moved.ok) break; // Exit the loop on successful move.
+                        message = "Error: " + moved.error + "\n";
                     }
 
                     // Check if the puzzle is solved.
-                    if (board.isSolved()) {
-                        timerRunning = false;
+                    if (moved.ok && moved.solved) {
                         clearScreen();
-                        updateTimer();
 
-                        board.printBoard();
-                        cout << "\nFinal Time: " << formatTime(elapsedSeconds) << "\n";
+                        session.getBoard().printBoard();
+                        cout << "\nFinal Time: " << formatTime(moved.seconds) << "\n";
 
                         cout << "\t\t\t<================================================================================>" << endl;
                         cout << "\t\t\t|                                Congratulations!                                |" << endl;
                         cout << "\t\t\t|                           You have solved the puzzle!                          |" << endl;
                         cout << "\t\t\t<================================================================================>" << endl;
 
-                        int timeBonus = max(0, 300 - elapsedSeconds)/10*difficulty; // Bonus fot solving under 5 minutes
-                        score += timeBonus;
-
-                        cout << "Time Bonus: +" << (timeBonus) << " points\n";
-                        cout << "Final Score: " << score << " points\n";
+                        // The session has added the time bonus and recorded the score.
+                        cout << "Time Bonus: +" << (moved.timeBonus) << " points\n";
+                        cout << "Final Score: " << moved.score << " points\n";
 
-                        leaderboard.addResult(playerName, score);
-                        leaderboard.display();
+                        leaderboard.display(10, session.getPlayerName());
 
-                        cout << "Press Enter to exit...";
-                        cin.clear();
-                        cin.ignore(numeric_limits<streamsize>::max(), '\n');
-                        cin.get();
+                        string line;
+                        readLine("", "Press Enter to exit...", line);
                         return;
                     }
                     break;
                 }
                 case 2: { // Get a hint.
-                    auto hint = board.getHint();
-                    if (hint.first != -1) {
-                        cout << "Hint: Cell (" << hint.first + 1 << ", " << hint.second + 1 << ") should be " << board.getSolutionValue(hint.first, hint.second) << "\n";
-                        score -= 5; // Deduct points for using a hint.
+                    GameResult hint = session.hint(); // Costs points for using a hint.
+                    if (hint.ok) {
+                        status = "Hint: Cell (" + to_string(hint.row + 1) + ", " + to_string(hint.col + 1) +
+                                 ") should be " + to_string(hint.value) + " (" + hint.technique + ")\n";
                     } else {
-                        cout << "No empty cells left!\n";
+                        status = hint.error + "!\n";
                     }
-                    cout << "Press Enter to continue...";
-                    cin.ignore(numeric_limits<streamsize>::max(), '\n');
                     break;
                 }
                 case 3: { // Start a new game.
+                    saveGame();
                     cout << "\nStarting new game...\n";
-                    timerRunning = false;
                     start();
                     return;
                 }
                 case 4: { // Delete a cell.
-                    int row, col, num;
-                    cout << "Enter row (1-9) and column (1-9): ";
-                    cin >> row >> col;
-                    board.deleteMove(row - 1, col - 1);
+                    string line;
+                    if (!readLine(screen, "Enter row (1-9) and column (1-9): ", line)) break;
+                    istringstream in(line);
+                    int row = 0, col = 0;
+                    in >> row >> col;
+                    GameResult erased = session.erase(row - 1, col - 1);
+                    if (!erased.ok) throw invalid_argument(erased.error);
                     break;
                 }
                 case 5: { // Display leaderboard.
-                    leaderboard.display();
-                    cout << "Press Enter to continue...";
-                    cin.ignore(numeric_limits<streamsize>::max(), '\n');
+                    ostringstream table;
+                    leaderboard.display(10, "", table);
+                    string line;
+                    readLine(screen + table.str(), "Press Enter to continue...", line);
                     break;
                 }
                 case 6: { // Exit the game.
                     cout << "\nThank you for playing!\n";
-                    updateTimer();
-                    cout << "\nTime: " << formatTime(elapsedSeconds) << "\n";
-                    cin.clear();
-                    cin.ignore(numeric_limits<streamsize>::max(), '\n');
+                    cout << "\nTime: " << formatTime(session.elapsedSeconds()) << "\n";
+                    saveGame();
+                    string line;
+                    readLine("", "", line);
                     return;
                 }
                 default: {
-                    cout << "Invalid choice!\n";
+                    status = "Invalid choice!\n";
                 }
             }
         } catch (const exception& e) {
-            cout << "Error: " << e.what() << "\n";
-            cout << "Press Enter to continue...";
-            cin.ignore(numeric_limits<streamsize>::max(), '\n');
+            status = string("Error: ") + e.what() + "\n";
         }
     }
 }
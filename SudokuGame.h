@@ -1,39 +1,52 @@
 #ifndef SUDOKU_GAME_H
 #define SUDOKU_GAME_H
 
-#include "SudokuBoard.h"
 #include "Leaderboard.h"
 #include "Solver.h"
+#include "SolutionCache.h"
+#include "PuzzlePool.h"
+#include "GameSession.h"
+#include "TerminalRenderer.h"
+#include "TerminalInput.h"
 #include <string>
-#include <chrono>
 using namespace std;
-using namespace std::chrono;
 
 class SudokuGame {
 private:
-    SudokuBoard board;
-    int difficulty;
     Leaderboard leaderboard;
-    string playerName;
-    int score;
-    Solver solver;
+    InstrumentedSolver solver;
+    SolutionCache solutions;
+    PuzzlePool puzzlePool;
+    GameSession session;
+    TerminalRenderer renderer;
+    TerminalInput input;
 
-    time_point<system_clock> startTime;
-    int elapsedSeconds;
-    bool timerRunning;
+    static constexpr const char* CLOCK_LABEL = "\nTime: ";    // Starts the game screen.
+    static const size_t MAX_LINE = 64;
 
     void clearScreen();
-    int getValidInput(const string& prompt, int min, int max);
+    bool readLine(const string& screen, const string& prompt, string& line);
+    bool readLiveLine(const string& screen, const string& prompt, string& line);
+    int getValidInput(const string& prompt, int min, int max, const string& screen = "");
+    string gameScreen();
     void playGame();
 
-    void updateTimer();
-    void startTimer();
     string formatTime(int seconds);
 
+    static string savePath(const string& playerName);
+    void saveGame();
+    bool offerResume(const string& playerName);
+
     void handleSolvePuzzle();
 
 public:
+    static constexpr const char* LEADERBOARD_FILE = "leaderboard.dat";
+    static constexpr const char* SAVE_DIR = "saves";
+    static constexpr const char* SOLUTION_CACHE_FILE = "solutions.cache";
+
     SudokuGame();
+    ~SudokuGame();
+    void setJournal(MoveJournal* journal);
     void start();
 };
 
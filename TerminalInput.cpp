@@ -0,0 +1,175 @@
+#include "TerminalInput.h"
+#include <algorithm>
+#include <cstdio>
+
+#ifdef _WIN32
+    #include <conio.h>
+    #include <io.h>
+    #include <windows.h>
+#else
+    #include <poll.h>
+    #include <termios.h>
+    #include <unistd.h>
+    #include <cerrno>
+    #include <csignal>
+#endif
+
+using namespace std;
+
+#ifndef _WIN32
+namespace {
+    // Ctrl-C and kill end the process without unwinding, so RawMode's destructor never
+    // runs. While raw mode is on, these signals put the terminal back first and then take
+    // their usual course.
+    const int RESTORED_SIGNALS[] = {SIGINT, SIGTERM, SIGHUP, SIGQUIT};
+    termios signalSaved;
+    struct sigaction previous[sizeof(RESTORED_SIGNALS) / sizeof(RESTORED_SIGNALS[0])];
+
+    void restoreAndRaise(int signal) {
+        tcsetattr(STDIN_FILENO, TCSANOW, &signalSaved);
+        ::signal(signal, SIG_DFL);
+        raise(signal);
+    }
+
+    void catchSignals(const termios& original) {
+        signalSaved = original;
+        struct sigaction handler = {};
+        handler.sa_handler = restoreAndRaise;
+        sigemptyset(&handler.sa_mask);
+        for (size_t i = 0; i < sizeof(RESTORED_SIGNALS) / sizeof(RESTORED_SIGNALS[0]); i++) {
+            sigaction(RESTORED_SIGNALS[i], &handler, &previous[i]);
+        }
+    }
+
+    void releaseSignals() {
+        for (size_t i = 0; i < sizeof(RESTORED_SIGNALS) / sizeof(RESTORED_SIGNALS[0]); i++) {
+            sigaction(RESTORED_SIGNALS[i], &previous[i], nullptr);
+        }
+    }
+}
+#endif
+
+// Constructor: Live input needs a terminal on both ends; with piped input the game
+// falls back to reading whole lines.
+TerminalInput::TerminalInput() : raw(false), pendingStart(0), pendingEnd(0) {
+#ifdef _WIN32
+    interactive = _isatty(0) && _isatty(1);
+#else
+    interactive = isatty(STDIN_FILENO) && isatty(STDOUT_FILENO);
+    saved = new termios();
+#endif
+}
+
+TerminalInput::~TerminalInput() {
+    restore();
+#ifndef _WIN32
+    delete saved;
+#endif
+}
+
+bool TerminalInput::isInteractive() const {
+    return interactive;
+}
+
+// Turns off line buffering and echo; Ctrl-C still interrupts and leaves the terminal as it was.
+void TerminalInput::enableRaw() {
+    if (!interactive || raw) return;
+#ifndef _WIN32
+    if (tcgetattr(STDIN_FILENO, saved) != 0) return;
+    catchSignals(*saved);
+    termios settings = *saved;
+    settings.c_lflag &= ~(ICANON | ECHO);
+    settings.c_cc[VMIN] = 1;
+    settings.c_cc[VTIME] = 0;
+    if (tcsetattr(STDIN_FILENO, TCSANOW, &settings) != 0) {
+        releaseSignals();
+        return;
+    }
+#endif
+    raw = true;     // _getch already reads unbuffered and unechoed on Windows.
+}
+
+// Puts the terminal back the way it was. Keys already read stay pending for the next
+// readKey, so typing ahead across a switch of modes loses nothing.
+void TerminalInput::restore() {
+    if (!raw) return;
+#ifndef _WIN32
+    tcsetattr(STDIN_FILENO, TCSANOW, saved);
+    releaseSignals();
+#endif
+    raw = false;
+}
+
+// Length of the escape sequence at the front of the pending bytes: ESC [ parameters and a
+// final byte (CSI: arrows, function keys), ESC O and one byte (SS3), or ESC and one key (Alt).
+int TerminalInput::escapeLength() const {
+    const unsigned char* sequence = pending + pendingStart;
+    int available = pendingEnd - pendingStart;
+    if (available < 2) return available;
+    if (sequence[1] == '[') {
+        for (int i = 2; i < available; i++) {
+            if (sequence[i] >= 0x40 && sequence[i] <= 0x7E) return i + 1;
+        }
+        return available;   // Cut off by the end of the read; drop what arrived.
+    }
+    return sequence[1] == 'O' ? min(3, available) : 2;
+}
+
+// Waits up to `timeoutMs` (forever if negative) for a key and returns it, NONE on timeout
+// or END at end of input. Escape sequences (arrow and function keys) are swallowed whole,
+// and keys typed after one in the same read are kept.
+int TerminalInput::readKey(int timeoutMs) {
+    while (pendingStart == pendingEnd) {
+#ifdef _WIN32
+        HANDLE console = GetStdHandle(STD_INPUT_HANDLE);
+        DWORD wait = timeoutMs < 0 ? INFINITE : static_cast<DWORD>(timeoutMs);
+        if (WaitForSingleObject(console, wait) != WAIT_OBJECT_0) return NONE;
+        if (!_kbhit()) return NONE;    // Mouse or focus events; _kbhit drops them.
+        int key = _getch();
+        if (key == 0 || key == 0xE0) {
+            _getch();                   // Second half of a function or arrow key.
+            return NONE;
+        }
+        return key == 26 ? END : key;   // Ctrl-Z
+#else
+        pollfd waiting = {STDIN_FILENO, POLLIN, 0};
+        int ready = poll(&waiting, 1, timeoutMs);
+        if (ready < 0 && errno == EINTR) return NONE;
+        if (ready <= 0) return ready == 0 ? NONE : END;
+        ssize_t got = read(STDIN_FILENO, pending, sizeof(pending));
+        if (got < 0 && (errno == EINTR || errno == EAGAIN)) return NONE;
+        if (got <= 0) return END;
+        pendingStart = 0;
+        pendingEnd = static_cast<int>(got);
+#endif
+    }
+    if (pending[pendingStart] == 27) {
+        pendingStart += escapeLength();
+        return NONE;
+    }
+    int key = pending[pendingStart++];
+    return key == 4 ? END : key;    // Ctrl-D
+}
+
+TickScheduler::TickScheduler(chrono::steady_clock::time_point start, chrono::steady_clock::duration interval)
+    : origin(start), period(interval) {
+    auto now = chrono::steady_clock::now();
+    auto passed = max(now - origin, chrono::steady_clock::duration::zero());
+    next = origin + (passed / period + 1) * period;
+}
+
+// Milliseconds until the next tick, rounded up so a poll never wakes just before it.
+int TickScheduler::millisUntilDue() const {
+    auto left = next - chrono::steady_clock::now();
+    if (left <= chrono::steady_clock::duration::zero()) return 0;
+    return static_cast<int>(chrono::duration_cast<chrono::milliseconds>(left + chrono::milliseconds(1) -
+                                                                        chrono::nanoseconds(1)).count());
+}
+
+// True once per period; a late check still counts as one tick, and the next one stays aligned.
+bool TickScheduler::due() {
+    auto now = chrono::steady_clock::now();
+    if (now < next) return false;
+    next = origin + ((now - origin) / period + 1) * period;
+    return true;
+}
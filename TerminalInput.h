@@ -0,0 +1,63 @@
+#ifndef TERMINAL_INPUT_H
+#define TERMINAL_INPUT_H
+
+#include <chrono>
+using namespace std;
+
+// Keystroke reader for the live game screen. In raw mode keys arrive one at a time,
+// unechoed, and readKey() sleeps in poll() until a key comes or the timeout passes,
+// so the caller can redraw a clock between keys without spinning.
+class TerminalInput {
+public:
+    static const int NONE = -1;     // The timeout passed without a key.
+    static const int END = -2;      // End of input.
+
+    // Raw mode for as long as it is in scope.
+    class RawMode {
+        TerminalInput& input;
+    public:
+        explicit RawMode(TerminalInput& terminal) : input(terminal) { input.enableRaw(); }
+        ~RawMode() { input.restore(); }
+        RawMode(const RawMode&) = delete;
+        RawMode& operator=(const RawMode&) = delete;
+    };
+
+private:
+    bool interactive;
+    bool raw;
+    unsigned char pending[32];      // Bytes read but not handed out yet.
+    int pendingStart;
+    int pendingEnd;
+#ifndef _WIN32
+    struct termios* saved;
+#endif
+
+    void enableRaw();
+    void restore();
+    int escapeLength() const;
+
+public:
+    TerminalInput();
+    ~TerminalInput();
+    TerminalInput(const TerminalInput&) = delete;
+    TerminalInput& operator=(const TerminalInput&) = delete;
+
+    bool isInteractive() const;
+    int readKey(int timeoutMs);
+};
+
+// Deadlines every `period` from an origin, e.g. once per second of game time: tells a
+// poll loop how long it may sleep and whether a tick is due.
+class TickScheduler {
+    chrono::steady_clock::time_point origin;
+    chrono::steady_clock::duration period;
+    chrono::steady_clock::time_point next;
+
+public:
+    TickScheduler(chrono::steady_clock::time_point start, chrono::steady_clock::duration interval);
+
+    int millisUntilDue() const;
+    bool due();
+};
+
+#endif // TERMINAL_INPUT_H
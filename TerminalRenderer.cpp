@@ -0,0 +1,226 @@
+#include "TerminalRenderer.h"
+#include <algorithm>
+#include <cstdio>
+#include <iostream>
+
+#ifdef _WIN32
+    #include <io.h>
+    #include <windows.h>
+#else
+    #include <sys/ioctl.h>
+    #include <unistd.h>
+#endif
+
+using namespace std;
+
+static const int TAB_WIDTH = 8;
+static const int MERGE_GAP = 4; // Unchanged cells worth rewriting to save a cursor move.
+
+TerminalRenderer::TerminalRenderer()
+    : styles{"\033[0m"}, valid(false), cursorRow(0), cursorCol(0), bytesWritten(0) {
+#ifdef _WIN32
+    // Let the console interpret the ANSI sequences.
+    HANDLE console = GetStdHandle(STD_OUTPUT_HANDLE);
+    DWORD mode = 0;
+    if (GetConsoleMode(console, &mode)) SetConsoleMode(console, mode | ENABLE_VIRTUAL_TERMINAL_PROCESSING);
+#endif
+}
+
+// Returns the index of an SGR sequence, registering it on first use.
+uint8_t TerminalRenderer::styleIndex(const string& sequence) {
+    if (sequence == "\033[0m" || sequence == "\033[m") return 0;
+    for (size_t i = 1; i < styles.size(); i++) {
+        if (styles[i] == sequence) return static_cast<uint8_t>(i);
+    }
+    if (styles.size() > UINT8_MAX) return 0;
+    styles.push_back(sequence);
+    return static_cast<uint8_t>(styles.size() - 1);
+}
+
+// Lays a frame out into the back buffer, expanding tabs and tracking color codes.
+void TerminalRenderer::parse(const string& frame) {
+    back.assign(1, {});
+    uint8_t style = 0;
+    for (size_t i = 0; i < frame.size(); i++) {
+        char c = frame[i];
+        if (c == '\033' && i + 1 < frame.size() && frame[i + 1] == '[') {
+            size_t end = frame.find_first_of("ABCDEFGHJKSTfmsu", i + 2);
+            if (end == string::npos) break;
+            if (frame[end] == 'm') style = styleIndex(frame.substr(i, end - i + 1));
+            i = end; // Other control sequences have no place in a frame and are dropped.
+        } else if (c == '\n') {
+            back.emplace_back();
+        } else if (c == '\t') {
+            do back.back().push_back({' ', style}); while (back.back().size() % TAB_WIDTH != 0);
+        } else if (c != '\r') {
+            back.back().push_back({c, style});
+        }
+    }
+    cursorRow = static_cast<int>(back.size()) - 1;
+    cursorCol = static_cast<int>(back.back().size());
+}
+
+// Size of the terminal in columns and rows, each 0 if it is not known.
+static void terminalSize(int& columns, int& rows) {
+    columns = rows = 0;
+#ifdef _WIN32
+    CONSOLE_SCREEN_BUFFER_INFO info;
+    if (GetConsoleScreenBufferInfo(GetStdHandle(STD_OUTPUT_HANDLE), &info)) {
+        columns = info.dwSize.X;
+        rows = info.srWindow.Bottom - info.srWindow.Top + 1;
+    }
+#else
+    winsize size;
+    if (ioctl(STDOUT_FILENO, TIOCGWINSZ, &size) == 0) {
+        columns = size.ws_col;
+        rows = size.ws_row;
+    }
+#endif
+}
+
+void TerminalRenderer::moveTo(int row, int col) {
+    out += "\033[" + to_string(row + 1) + ";" + to_string(col + 1) + "H";
+}
+
+// Writes the pending output with one system call.
+void TerminalRenderer::flush() {
+    cout.flush();
+    fflush(stdout);
+    const char* data = out.data();
+    size_t left = out.size();
+    while (left > 0) {
+#ifdef _WIN32
+        int written = _write(1, data, static_cast<unsigned>(left));
+#else
+        ssize_t written = write(STDOUT_FILENO, data, left);
+#endif
+        if (written <= 0) break;
+        data += written;
+        left -= static_cast<size_t>(written);
+    }
+    bytesWritten = out.size();
+    out.clear();
+}
+
+// Shows a frame, sending only what differs from the one on screen.
+void TerminalRenderer::present(const string& frame) {
+    int shownRow = cursorRow, shownCol = cursorCol;
+    parse(frame);
+    out.clear();
+
+    // Lines the terminal wraps, or a frame as tall as the window so that the terminal
+    // scrolls, would throw off the cursor arithmetic, so such a frame is written out
+    // whole after a clear, like a plain redraw.
+    int columns, rows;
+    terminalSize(columns, rows);
+    bool fits = rows <= 0 || static_cast<int>(back.size()) < rows;
+    for (const vector<Cell>& line : back) {
+        if (columns > 0 && static_cast<int>(line.size()) >= columns) fits = false;
+    }
+    if (!fits) {
+        out = "\033[H\033[2J" + frame;
+        flush();
+        front.clear();
+        valid = false;
+        return;
+    }
+    if (!valid) {
+        out += "\033[H\033[2J";
+        front.clear();
+    } else {
+        // Prompts and echoed input went below the last frame; wipe them first.
+        moveTo(shownRow, shownCol);
+        out += "\033[J";
+    }
+
+    static const Cell BLANK = {' ', 0};
+    uint8_t current = 0;
+    for (size_t row = 0; row < back.size(); row++) {
+        const vector<Cell>& next = back[row];
+        const vector<Cell>* previous = row < front.size() ? &front[row] : nullptr;
+        auto shown = [&](size_t col) { return previous && col < previous->size() ? (*previous)[col] : BLANK; };
+
+        size_t col = 0;
+        while (col < next.size()) {
+            if (next[col] == shown(col)) {
+                col++;
+                continue;
+            }
+            // Extend the changed run across short stretches of unchanged cells.
+            size_t end = col + 1, lastChanged = col;
+            while (end < next.size() && end - lastChanged <= MERGE_GAP) {
+                if (next[end] != shown(end)) lastChanged = end;
+                end++;
+            }
+            moveTo(static_cast<int>(row), static_cast<int>(col));
+            for (; col <= lastChanged; col++) {
+                if (next[col].style != current) {
+                    if (next[col].style != 0) out += styles[0]; // Start from a clean slate.
+                    current = next[col].style;
+                    out += styles[current];
+                }
+                out += next[col].ch;
+            }
+        }
+        if (previous && previous->size() > next.size()) {
+            if (current != 0) {
+                out += styles[0];
+                current = 0;
+            }
+            moveTo(static_cast<int>(row), static_cast<int>(next.size()));
+            out += "\033[K"; // The old line was longer.
+        }
+    }
+    if (current != 0) out += styles[0];
+
+    // Leave the cursor where the frame ends and drop what is left of a longer frame.
+    moveTo(cursorRow, cursorCol);
+    out += "\033[J";
+    flush();
+    front.swap(back);
+    valid = true;
+}
+
+// Rewrites a stretch of one line of the frame on screen in the default style, e.g. a clock,
+// and puts the cursor back at the end of the frame. Returns false (writing nothing) if that
+// part of the frame is not on screen, or the terminal has shrunk so that the frame scrolled
+// and its rows moved; present() the whole frame instead.
+bool TerminalRenderer::patch(int row, int col, const string& text) {
+    if (!valid || row < 0 || row >= static_cast<int>(front.size()) || col < 0 ||
+        col + text.size() > front[row].size()) {
+        return false;
+    }
+    int columns, rows;
+    terminalSize(columns, rows);
+    if (rows > 0 && static_cast<int>(front.size()) >= rows) {
+        valid = false;
+        return false;
+    }
+    out.clear();
+    moveTo(row, col);
+    out += styles[0];
+    out += text;
+    moveTo(cursorRow, cursorCol);
+    flush();
+    for (size_t i = 0; i < text.size(); i++) front[row][col + i] = {text[i], 0};
+    return true;
+}
+
+// Clears the screen now; the next frame is drawn in full.
+void TerminalRenderer::clear() {
+    out = "\033[H\033[2J";
+    flush();
+    front.clear();
+    cursorRow = cursorCol = 0;
+    valid = true;
+}
+
+// Forgets what is on screen, e.g. after other output overwrote the frame.
+void TerminalRenderer::invalidate() {
+    valid = false;
+}
+
+// Bytes sent by the most recent present() or clear().
+size_t TerminalRenderer::lastFrameBytes() const {
+    return bytesWritten;
+}
@@ -0,0 +1,47 @@
+#ifndef TERMINAL_RENDERER_H
+#define TERMINAL_RENDERER_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+using namespace std;
+
+// Redraws the screen by diffing frames. A frame is plain text with ANSI color codes;
+// present() compares it with the previous frame and writes only the cursor moves and
+// cells that changed, then clears whatever was printed below the frame, all in a
+// single write. The frame is assumed to stay on screen between calls; anything that
+// prints over it must call clear() or invalidate().
+class TerminalRenderer {
+private:
+    struct Cell {
+        char ch;
+        uint8_t style;  // Index into `styles`; 0 is the default style.
+        bool operator==(const Cell& other) const { return ch == other.ch && style == other.style; }
+        bool operator!=(const Cell& other) const { return !(*this == other); }
+    };
+
+    vector<vector<Cell>> front;     // What the terminal currently shows.
+    vector<vector<Cell>> back;      // The frame being presented.
+    vector<string> styles;          // Distinct SGR sequences seen so far.
+    bool valid;
+    int cursorRow;
+    int cursorCol;
+    string out;
+    size_t bytesWritten;
+
+    void parse(const string& frame);
+    uint8_t styleIndex(const string& sequence);
+    void moveTo(int row, int col);
+    void flush();
+
+public:
+    TerminalRenderer();
+
+    void present(const string& frame);
+    bool patch(int row, int col, const string& text);
+    void clear();
+    void invalidate();
+    size_t lastFrameBytes() const;
+};
+
+#endif
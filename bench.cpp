@@ -0,0 +1,275 @@
+//g++ -std=c++17 -O2 -pthread bench.cpp Solver.cpp DlxSolver.cpp SimdSolver.cpp SolverBackend.cpp ParallelSolver.cpp SolverStats.cpp SudokuBoard.cpp GridGenerator.cpp -o sudoku_bench
+
+// Solver benchmark: runs every solver backend over the bundled corpora in puzzles/,
+// the 9x9 ones and one each of 16x16 and 25x25, and reports latency percentiles and
+// throughput, optionally as JSON.
+// Engines that solve several puzzles at once only time whole groups, so for them just
+// the mean, the average over groups, is reported per puzzle.
+//
+// Usage: sudoku_bench [--corpus DIR] [--solver NAME|all] [--repeat N] [--json FILE|-] [--stats]
+
+#include "SolverBackend.h"
+#include "SudokuBoard.h"
+#include <algorithm>
+#include <bitset>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+using namespace std;
+
+struct BenchResult {
+    string corpus;
+    string solver;
+    size_t puzzles = 0;
+    size_t solves = 0;
+    size_t failures = 0;
+    double meanMicros = 0;
+    double p50Micros = 0;
+    double p99Micros = 0;
+    double maxMicros = 0;
+    double puzzlesPerSecond = 0;
+    double nodesPerSecond = 0;
+    long long nodes = 0;
+    size_t groupWidth = 1;      // Puzzles solved together; above 1, latencies are group averages.
+    SolverStats stats;         // Filled only with --stats by instrumented engines.
+};
+
+// Reads one puzzle per line, skipping blank lines and '#' comments. Digits above 9
+// are letters from 'A' (see GridTraits::digitOf).
+template <int BOX>
+static bool loadCorpus(const string& path, vector<typename GridTraits<BOX>::Grid>& puzzles) {
+    using Traits = GridTraits<BOX>;
+    ifstream file(path);
+    if (!file.is_open()) return false;
+
+    string line;
+    while (getline(file, line)) {
+        if (line.size() < Traits::CELLS || line[0] == '#') continue;
+        typename Traits::Grid grid;
+        for (int i = 0; i < Traits::CELLS; i++) {
+            grid[i] = static_cast<uint8_t>(max(0, Traits::digitOf(line[i])));
+        }
+        puzzles.push_back(grid);
+    }
+    return true;
+}
+
+// True if `answer` is a complete valid grid that keeps every given of `puzzle`; loading
+// it into a board runs exactly those checks.
+template <int BOX>
+static bool isValidAnswer(const typename GridTraits<BOX>::Grid& puzzle, const typename GridTraits<BOX>::Grid& answer) {
+    bitset<GridTraits<BOX>::CELLS> givens;
+    for (int i = 0; i < GridTraits<BOX>::CELLS; i++) givens[i] = puzzle[i] != 0;
+    BasicSudokuBoard<BOX> board;
+    try {
+        board.load(puzzle, answer, givens);
+    } catch (const invalid_argument&) {
+        return false;
+    }
+    return true;
+}
+
+// Value at the given fraction of a sorted sample.
+static double percentile(const vector<double>& sorted, double p) {
+    if (sorted.empty()) return 0;
+    size_t index = min(sorted.size() - 1, static_cast<size_t>(p * sorted.size()));
+    return sorted[index];
+}
+
+// Solves the whole corpus `repeat` times, in groups of the engine's batch width. Wrong
+// answers count as failures, like unsolved puzzles; checking them is not timed.
+template <int BOX>
+static BenchResult runCorpus(BasicSolverBackend<BOX>& solver, const string& corpus,
+                             const vector<typename GridTraits<BOX>::Grid>& puzzles, int repeat) {
+    BenchResult result;
+    result.corpus = corpus;
+    result.solver = solver.name();
+    result.puzzles = puzzles.size();
+
+    size_t width = solver.batchWidth();
+    result.groupWidth = width;
+    vector<typename GridTraits<BOX>::Grid> group(width);
+    unique_ptr<bool[]> solved(new bool[width]);
+    vector<double> latencies;
+    double totalMicros = 0;
+
+    for (int r = 0; r < repeat; r++) {
+        for (size_t start = 0; start < puzzles.size(); start += width) {
+            int n = static_cast<int>(min(width, puzzles.size() - start));
+            copy(puzzles.begin() + start, puzzles.begin() + start + n, group.begin());
+
+            auto begin = chrono::steady_clock::now();
+            solver.solveMany(group.data(), solved.get(), n);
+            double micros = chrono::duration<double, micro>(chrono::steady_clock::now() - begin).count();
+
+            result.nodes += solver.getNodeCount();
+            if (const SolverStats* last = solver.getStats()) result.stats.add(*last);
+            totalMicros += micros;
+            for (int k = 0; k < n; k++) {
+                latencies.push_back(micros / n);
+                if (!solved[k] || !isValidAnswer<BOX>(puzzles[start + k], group[k])) result.failures++;
+            }
+        }
+    }
+
+    sort(latencies.begin(), latencies.end());
+    result.solves = latencies.size();
+    if (result.solves > 0) result.meanMicros = totalMicros / result.solves;
+    if (totalMicros > 0) result.puzzlesPerSecond = result.solves / (totalMicros / 1e6);
+    // Percentiles of group averages say nothing about single puzzles, and the node
+    // count leaves out the lanes solved by vector code.
+    if (width > 1 || result.solves == 0) return result;
+
+    result.p50Micros = percentile(latencies, 0.50);
+    result.p99Micros = percentile(latencies, 0.99);
+    result.maxMicros = latencies.back();
+    if (totalMicros > 0) result.nodesPerSecond = result.nodes / (totalMicros / 1e6);
+    return result;
+}
+
+// Prints one result as a row of the table.
+static void printRow(const BenchResult& r) {
+    cout << left << setw(12) << r.corpus << setw(10) << r.solver << right << fixed
+         << setw(8) << r.puzzles << setprecision(1) << setw(11) << r.meanMicros;
+    if (r.groupWidth > 1) {
+        cout << setw(11) << "-" << setw(11) << "-" << setw(11) << "-"
+             << setprecision(0) << setw(13) << r.puzzlesPerSecond << setw(14) << "-";
+    } else {
+        cout << setw(11) << r.p50Micros << setw(11) << r.p99Micros << setw(11) << r.maxMicros
+             << setprecision(0) << setw(13) << r.puzzlesPerSecond << setw(14) << r.nodesPerSecond;
+    }
+    cout << (r.failures ? "  (unsolved: " + to_string(r.failures) + ")" : "") << "\n";
+    if (r.stats.solves > 0) {
+        cout << "    " << r.stats.guesses << " guesses, " << r.stats.backtracks << " backtracks, "
+             << r.stats.propagations << " propagated digits, max depth " << r.stats.maxDepth << "\n";
+    }
+}
+
+// Runs the chosen solvers over the named corpora of one grid size. Solvers that do not
+// exist for this size (simd is 9x9 only) are skipped unless the size is 9x9.
+template <int BOX>
+static bool benchCorpora(const string& corpusDir, const vector<string>& corpora, const string& solverName,
+                         bool stats, int repeat, vector<BenchResult>& results) {
+    using Backend = BasicSolverBackend<BOX>;
+    vector<string> solverNames = solverName == "all" ? Backend::available() : vector<string>{solverName};
+    for (const string& corpus : corpora) {
+        vector<typename Backend::Grid> puzzles;
+        string path = corpusDir + "/" + corpus + ".txt";
+        if (!loadCorpus<BOX>(path, puzzles)) {
+            cerr << "Cannot open " << path << "\n";
+            return false;
+        }
+
+        for (const string& name : solverNames) {
+            unique_ptr<Backend> solver = Backend::create(name, stats);
+            if (!solver && BOX != 3) continue;
+            if (!solver) {
+                cerr << "Unknown solver '" << name << "'\n";
+                return false;
+            }
+
+            BenchResult r = runCorpus<BOX>(*solver, corpus, puzzles, repeat);
+            results.push_back(r);
+            printRow(r);
+        }
+    }
+    return true;
+}
+
+// Writes all results as one JSON document.
+static void writeJson(const vector<BenchResult>& results, ostream& out) {
+    auto now = chrono::duration_cast<chrono::seconds>(chrono::system_clock::now().time_since_epoch()).count();
+    out << "{\n  \"timestamp\": " << now << ",\n  \"results\": [\n";
+    for (size_t i = 0; i < results.size(); i++) {
+        const BenchResult& r = results[i];
+        out << fixed << setprecision(3)
+            << "    {\"corpus\": \"" << r.corpus << "\", \"solver\": \"" << r.solver << "\""
+            << ", \"puzzles\": " << r.puzzles
+            << ", \"solves\": " << r.solves
+            << ", \"failures\": " << r.failures
+            << ", \"mean_us\": " << r.meanMicros
+            << ", \"puzzles_per_s\": " << r.puzzlesPerSecond;
+        if (r.groupWidth > 1) {
+            out << ", \"latency\": \"group_average\", \"group_width\": " << r.groupWidth;
+        } else {
+            out << ", \"p50_us\": " << r.p50Micros
+                << ", \"p99_us\": " << r.p99Micros
+                << ", \"max_us\": " << r.maxMicros
+                << ", \"nodes\": " << r.nodes
+                << ", \"nodes_per_s\": " << r.nodesPerSecond;
+        }
+        if (r.stats.solves > 0) {
+            out << ", \"guesses\": " << r.stats.guesses
+                << ", \"backtracks\": " << r.stats.backtracks
+                << ", \"propagations\": " << r.stats.propagations
+                << ", \"max_depth\": " << r.stats.maxDepth;
+        }
+        out << "}"
+            << (i + 1 < results.size() ? "," : "") << "\n";
+    }
+    out << "  ]\n}\n";
+}
+
+int main(int argc, char* argv[]) {
+    string corpusDir = "puzzles";
+    string solverName = "all";
+    string jsonPath;
+    int repeat = 3;
+    bool stats = false;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--corpus") == 0 && i + 1 < argc) {
+            corpusDir = argv[++i];
+        } else if (strcmp(argv[i], "--solver") == 0 && i + 1 < argc) {
+            solverName = argv[++i];
+        } else if (strcmp(argv[i], "--repeat") == 0 && i + 1 < argc) {
+            repeat = max(1, atoi(argv[++i]));
+        } else if (strcmp(argv[i], "--json") == 0 && i + 1 < argc) {
+            jsonPath = argv[++i];
+        } else if (strcmp(argv[i], "--stats") == 0) {
+            stats = true;
+        } else {
+            cerr << "Usage: " << argv[0] << " [--corpus DIR] [--solver NAME|all] [--repeat N] [--json FILE|-] [--stats]\n";
+            return 1;
+        }
+    }
+
+    vector<BenchResult> results;
+
+    cout << left << setw(12) << "corpus" << setw(10) << "solver" << right
+         << setw(8) << "puzzles" << setw(11) << "mean us" << setw(11) << "p50 us"
+         << setw(11) << "p99 us" << setw(11) << "max us" << setw(13) << "puzzles/s"
+         << setw(14) << "nodes/s" << "\n";
+
+    if (!benchCorpora<3>(corpusDir, {"easy", "17clue", "hard", "adversarial"}, solverName, stats, repeat, results) ||
+        !benchCorpora<4>(corpusDir, {"16x16"}, solverName, stats, repeat, results) ||
+        !benchCorpora<5>(corpusDir, {"25x25"}, solverName, stats, repeat, results)) {
+        return 1;
+    }
+
+    for (const BenchResult& r : results) {
+        if (r.groupWidth == 1) continue;
+        cout << "(" << r.solver << ": mean is the group average, " << r.groupWidth << " puzzles are solved at once)\n";
+        break;
+    }
+
+    if (jsonPath == "-") {
+        writeJson(results, cout);
+    } else if (!jsonPath.empty()) {
+        ofstream json(jsonPath);
+        if (!json.is_open()) {
+            cerr << "Cannot write " << jsonPath << "\n";
+            return 1;
+        }
+        writeJson(results, json);
+    }
+    return 0;
+}
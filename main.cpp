@@ -1,13 +1,329 @@
-﻿//g++ main.cpp SudokuGame.cpp SudokuBoard.cpp Leaderboard.cpp -o sudoku
+﻿//g++ -std=c++17 -O2 -pthread main.cpp SudokuGame.cpp SudokuBoard.cpp Leaderboard.cpp LeaderboardFile.cpp Solver.cpp DlxSolver.cpp SimdSolver.cpp SolverBackend.cpp ParallelSolver.cpp SolverStats.cpp SolutionCache.cpp BatchSolver.cpp PuzzlePool.cpp GameSession.cpp GameServer.cpp LoadClient.cpp TerminalRenderer.cpp TerminalInput.cpp HintEngine.cpp DifficultyRater.cpp Canonicalizer.cpp GridGenerator.cpp GameSnapshot.cpp MoveJournal.cpp -o sudoku
 
 #include "SudokuGame.h"
+#include "BatchSolver.h"
+#include "Canonicalizer.h"
+#include "Leaderboard.h"
+#include "GameServer.h"
+#include "GridGenerator.h"
+#include "LoadClient.h"
+#include "MoveJournal.h"
+#include <chrono>
+#include <csignal>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
 #include <iostream>
+#include <memory>
+#include <thread>
+#include <unordered_set>
 using namespace std;
 
-int main() {
+// Headless mode: sudoku --batch [file|-] [--threads N] [--solver bitmask|dlx|simd|parallel] [--stats]
+//                             [--cache N] [--cache-file FILE]
+// Reads one 81-character puzzle per line, writes solutions in input order to stdout
+// and a throughput/latency summary to stderr. The parallel solver spreads each puzzle
+// over every core, so it pairs with --threads 1. With --cache, repeated puzzles are
+// answered from an LRU cache of N entries, loaded from and saved to --cache-file.
+static int runBatch(int argc, char* argv[]) {
+    string input = "-";
+    string backend = "bitmask";
+    unsigned threads = 0;
+    bool stats = false;
+    size_t cacheSize = 0;
+    string cacheFile;
+    for (int i = 2; i < argc; i++) {
+        if (strcmp(argv[i], "--threads") == 0 && i + 1 < argc) {
+            threads = static_cast<unsigned>(atoi(argv[++i]));
+        } else if (strcmp(argv[i], "--cache") == 0 && i + 1 < argc) {
+            cacheSize = static_cast<size_t>(max(0, atoi(argv[++i])));
+        } else if (strcmp(argv[i], "--cache-file") == 0 && i + 1 < argc) {
+            cacheFile = argv[++i];
+        } else if (strcmp(argv[i], "--solver") == 0 && i + 1 < argc) {
+            backend = argv[++i];
+        } else if (strcmp(argv[i], "--stats") == 0) {
+            stats = true;
+        } else {
+            input = argv[i];
+        }
+    }
+
+    if (!SolverBackend::create(backend)) {
+        cerr << "Unknown solver '" << backend << "'. Available:";
+        for (const string& name : SolverBackend::available()) cerr << " " << name;
+        cerr << endl;
+        return 1;
+    }
+
+    ios::sync_with_stdio(false);
+    BatchSolver batch(threads, backend, stats);
+    if (!cacheFile.empty() && cacheSize == 0) cacheSize = SolutionCache::DEFAULT_CAPACITY;
+    unique_ptr<SolutionCache> cache;
+    if (cacheSize > 0) {
+        cache.reset(new SolutionCache(cacheSize));
+        if (!cacheFile.empty()) cache->load(cacheFile);
+        batch.setCache(cache.get());
+    }
+    BatchSolver::Summary summary;
+    if (input == "-") {
+        summary = batch.run(cin, cout);
+    } else {
+        ifstream file(input);
+        if (!file.is_open()) {
+            cerr << "Cannot open " << input << endl;
+            return 1;
+        }
+        summary = batch.run(file, cout);
+    }
+    BatchSolver::printSummary(summary, cerr);
+    if (cache) {
+        SolutionCache::Stats cached = cache->stats();
+        cerr << "Cache: " << cached.hits << " hits, " << cached.misses << " misses (" << cached.hitRate() * 100
+             << "%), " << cached.evictions << " evictions, " << cached.size << "/" << cached.capacity << " entries"
+             << endl;
+        if (!cacheFile.empty() && !cache->save(cacheFile)) cerr << "Cannot save cache to " << cacheFile << endl;
+    }
+    return 0;
+}
+
+// sudoku --dedup [file|-]
+// Copies puzzles (one per line) to stdout, dropping any that is a relabelled, transposed or
+// row/column-swapped copy of one seen before. Unreadable lines are passed through.
+static int runDedup(int argc, char* argv[]) {
+    string input = argc > 2 ? argv[2] : "-";
+    ifstream file;
+    if (input != "-") {
+        file.open(input);
+        if (!file.is_open()) {
+            cerr << "Cannot open " << input << endl;
+            return 1;
+        }
+    }
+    istream& in = input == "-" ? cin : file;
+
+    ios::sync_with_stdio(false);
+    unordered_set<uint64_t> seen;
+    size_t total = 0, dropped = 0;
+    string line;
+    SolverBackend::Grid grid;
+    while (getline(in, line)) {
+        if (BatchSolver::parseLine(line, grid)) {
+            total++;
+            if (!seen.insert(Canonicalizer::hash(grid)).second) {
+                dropped++;
+                continue;
+            }
+        }
+        cout << line << '\n';
+    }
+    cerr << total << " puzzles, " << dropped << " duplicates removed" << endl;
+    return 0;
+}
+
+// sudoku --generate N [--threads T]
+// Writes N random complete grids, one 81-digit line each; every thread has its own generator.
+static int runGenerate(int argc, char* argv[]) {
+    long long count = atoll(argv[2]);
+    unsigned threads = thread::hardware_concurrency();
+    for (int i = 3; i < argc; i++) {
+        if (strcmp(argv[i], "--threads") == 0 && i + 1 < argc) {
+            threads = static_cast<unsigned>(atoi(argv[++i]));
+        }
+    }
+    threads = max(1u, threads);
+
+    const long long CHUNK = 1 << 16;
+    const int LINE = GridGenerator::CELLS + 1;
+    vector<GridGenerator> generators(threads);
+    string buffer;
+    auto start = chrono::steady_clock::now();
+    for (long long done = 0; done < count; done += CHUNK) {
+        long long batch = min(CHUNK, count - done);
+        buffer.assign(batch * LINE, '\n');
+        vector<thread> workers;
+        for (unsigned t = 0; t < threads; t++) {
+            workers.emplace_back([&, t] {
+                GridGenerator::Grid grid;
+                for (long long i = t; i < batch; i += threads) {
+                    generators[t].generate(grid);
+                    for (int cell = 0; cell < GridGenerator::CELLS; cell++) buffer[i * LINE + cell] = '0' + grid[cell];
+                }
+            });
+        }
+        for (thread& worker : workers) worker.join();
+        cout.write(buffer.data(), buffer.size());
+    }
+    double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    cerr << count << " grids in " << seconds << " s (" << static_cast<long long>(count / max(seconds, 1e-9))
+         << " grids/s, " << threads << " threads)" << endl;
+    return 0;
+}
+
+// sudoku --replay <journal>
+// Rebuilds every recorded session through SudokuBoard and prints what the players did.
+static int runReplay(int argc, char* argv[]) {
+    if (argc != 3) {
+        cerr << "Usage: " << argv[0] << " --replay <journal>" << endl;
+        return 1;
+    }
+    MoveJournal::Analytics stats;
+    if (!MoveJournal::replay(argv[2], stats)) {
+        cerr << "Cannot read journal " << argv[2] << endl;
+        return 1;
+    }
+    cout << "Sessions:         " << stats.sessions << " (" << stats.solved << " solved)\n";
+    cout << "Moves:            " << stats.moves << " (" << stats.wrongMoves << " wrong, error rate "
+         << stats.errorRate() * 100 << "%)\n";
+    cout << "Erases / hints:   " << stats.erases << " / " << stats.hints << "\n";
+    cout << "Seconds per cell: " << stats.secondsPerCell() << "\n";
+    if (stats.solved) cout << "Seconds to solve: " << stats.solveSeconds / stats.solved << " on average\n";
+    if (stats.rejected) cout << "Rejected records: " << stats.rejected << "\n";
+    cerr << stats.records << " records in " << stats.replaySeconds << " s ("
+         << static_cast<long long>(stats.records / max(stats.replaySeconds, 1e-9)) << " records/s)" << endl;
+    return 0;
+}
+
+// sudoku --convert-leaderboard <text file> <binary file>
+// Converts a text leaderboard (and any log next to it) to the memory-mapped format.
+static int runConvertLeaderboard(int argc, char* argv[]) {
+    if (argc != 4) {
+        cerr << "Usage: " << argv[0] << " --convert-leaderboard <text file> <binary file>" << endl;
+        return 1;
+    }
+    if (!Leaderboard::convert(argv[2], argv[3])) {
+        cerr << "Cannot convert " << argv[2] << " to " << argv[3] << endl;
+        return 1;
+    }
+    return 0;
+}
+
+static GameServer* runningServer = nullptr;
+
+static void stopServer(int) {
+    if (runningServer) runningServer->stop();
+}
+
+// sudoku --server [--port N | --unix PATH] [--pool N] [--journal FILE]
+// Hosts any number of game sessions over the GameServer line protocol until interrupted.
+// Journals are conventionally named *.journal (e.g. moves.journal).
+static int runServer(int argc, char* argv[]) {
+    int port = 7777;
+    string unixPath;
+    size_t poolDepth = 64;
+    string journalPath;
+    for (int i = 2; i < argc; i++) {
+        if (strcmp(argv[i], "--port") == 0 && i + 1 < argc) {
+            port = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--unix") == 0 && i + 1 < argc) {
+            unixPath = argv[++i];
+        } else if (strcmp(argv[i], "--pool") == 0 && i + 1 < argc) {
+            poolDepth = static_cast<size_t>(max(1, atoi(argv[++i])));
+        } else if (strcmp(argv[i], "--journal") == 0 && i + 1 < argc) {
+            journalPath = argv[++i];
+        }
+    }
+    if (!GameServer::isSupported()) {
+        cerr << "Server mode needs Linux (epoll)" << endl;
+        return 1;
+    }
+
+    PuzzlePool pool(poolDepth);
+    pool.start();
+    Leaderboard leaderboard(SudokuGame::LEADERBOARD_FILE);
+    MoveJournal journal;
+    if (!journalPath.empty() && !journal.open(journalPath)) {
+        cerr << "Cannot open journal " << journalPath << endl;
+        return 1;
+    }
+    GameServer server(pool, leaderboard, journal.isOpen() ? &journal : nullptr);
+    bool listening = unixPath.empty() ? server.listenTcp(port) : server.listenUnix(unixPath);
+    if (!listening) {
+        cerr << "Cannot listen on " << (unixPath.empty() ? "port " + to_string(port) : unixPath) << endl;
+        return 1;
+    }
+    cerr << "Listening on " << (unixPath.empty() ? "127.0.0.1:" + to_string(port) : unixPath) << endl;
+
+    runningServer = &server;
+    signal(SIGINT, stopServer);
+    signal(SIGTERM, stopServer);
+    server.run();
+    runningServer = nullptr;
+    cerr << "Served " << server.getCommandCount() << " commands" << endl;
+    journal.close();
+    if (journal.droppedRecords() > 0) {
+        cerr << "Journal " << journalPath << " is missing " << journal.droppedRecords() << " records (disk full?)" << endl;
+        return 1;
+    }
+    return 0;
+}
+
+// sudoku --bots N [--port N | --unix PATH] [--games G] [--threads T]
+// Scripted load: N concurrent sessions each play G games against a running server.
+static int runBots(int argc, char* argv[]) {
+    int sessions = atoi(argv[2]);
+    string endpoint = "7777";
+    int games = 1;
+    unsigned threads = 0;
+    for (int i = 3; i < argc; i++) {
+        if ((strcmp(argv[i], "--port") == 0 || strcmp(argv[i], "--unix") == 0) && i + 1 < argc) {
+            endpoint = argv[++i];
+        } else if (strcmp(argv[i], "--games") == 0 && i + 1 < argc) {
+            games = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--threads") == 0 && i + 1 < argc) {
+            threads = static_cast<unsigned>(atoi(argv[++i]));
+        }
+    }
+    LoadClient::Summary summary = LoadClient::run(endpoint, max(1, sessions), games, threads);
+    LoadClient::printSummary(summary, cerr);
+    return summary.errors == 0 ? 0 : 1;
+}
+
+int main(int argc, char* argv[]) {
     try {
+        if (argc > 1 && strcmp(argv[1], "--batch") == 0) {
+            return runBatch(argc, argv);
+        }
+        if (argc > 1 && strcmp(argv[1], "--dedup") == 0) {
+            return runDedup(argc, argv);
+        }
+        if (argc > 2 && strcmp(argv[1], "--generate") == 0) {
+            return runGenerate(argc, argv);
+        }
+        if (argc > 1 && strcmp(argv[1], "--convert-leaderboard") == 0) {
+            return runConvertLeaderboard(argc, argv);
+        }
+        if (argc > 1 && strcmp(argv[1], "--replay") == 0) {
+            return runReplay(argc, argv);
+        }
+        if (argc > 1 && strcmp(argv[1], "--server") == 0) {
+            return runServer(argc, argv);
+        }
+        if (argc > 2 && strcmp(argv[1], "--bots") == 0) {
+            return runBots(argc, argv);
+        }
+
+        // Older versions kept the leaderboard as text; convert it once.
+        error_code error;
+        if (!filesystem::exists(SudokuGame::LEADERBOARD_FILE, error) && filesystem::exists("leaderboard.txt", error)) {
+            Leaderboard::convert("leaderboard.txt", SudokuGame::LEADERBOARD_FILE);
+        }
+
+        // sudoku --journal FILE records the console games too.
+        MoveJournal journal;
+        if (argc > 2 && strcmp(argv[1], "--journal") == 0 && !journal.open(argv[2])) {
+            cerr << "Cannot open journal " << argv[2] << endl;
+            return 1;
+        }
+
         SudokuGame game;
+        if (journal.isOpen()) game.setJournal(&journal);
         game.start();
+        journal.close();
+        if (journal.droppedRecords() > 0) {
+            cerr << "Journal " << argv[2] << " is missing " << journal.droppedRecords() << " records (disk full?)" << endl;
+            return 1;
+        }
     }
     catch(const exception& e) {
         cerr << "Critical error: " << e.what() << endl;